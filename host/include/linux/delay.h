@@ -0,0 +1 @@
+#include <siw_host.h>
@@ -0,0 +1,2 @@
+#include_next <linux/types.h>
+#include <siw_host.h>
@@ -0,0 +1,1430 @@
+/*
+ * siw_host.h - SiW touch host build shims
+ *
+ * Copyright (C) 2016 Silicon Works - http://www.siliconworks.co.kr
+ * Author: Hyunho Kim <kimhh@siliconworks.co.kr>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#ifndef __SIW_HOST_H
+#define __SIW_HOST_H
+
+/*
+ * Minimal kernel API for building the core, event and hal code
+ * as a plain user program (see host/README_host.txt).
+ *
+ * Single threaded model :
+ * - mutex/spinlock only check the lock discipline (re-lock aborts)
+ * - works run from siw_host_run_works(), kthreads never start
+ * - msleep and friends advance a virtual clock
+ *   which is added to ktime_get() and jiffies
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <linux/types.h>
+
+/*
+ * types
+ */
+typedef __u8 u8;
+typedef __u16 u16;
+typedef __u32 u32;
+typedef __u64 u64;
+typedef __s8 s8;
+typedef __s16 s16;
+typedef __s32 s32;
+typedef __s64 s64;
+
+typedef long long loff_t_host;
+#define loff_t loff_t_host
+typedef unsigned int gfp_t;
+typedef u64 dma_addr_t;
+typedef u64 phys_addr_t;
+typedef unsigned int fmode_t;
+typedef unsigned short umode_t;
+typedef s64 ktime_t;
+
+/*
+ * compiler & generic macros
+ */
+#define __packed			__attribute__((packed))
+#define __used				__attribute__((used))
+#define __maybe_unused		__attribute__((unused))
+#define __always_unused		__attribute__((unused))
+#ifndef __weak
+#define __weak				__attribute__((weak))
+#endif
+#define __aligned(x)		__attribute__((aligned(x)))
+#define __printf(a, b)		__attribute__((format(printf, a, b)))
+#define __must_check
+#define __init
+#define __exit
+#define __initdata
+#define __devinit
+#define __devexit
+#define __user
+#define __iomem
+#define __force
+#define __read_mostly
+#define __cacheline_aligned
+#define ____cacheline_aligned
+#define noinline			__attribute__((noinline))
+#define notrace
+#define asmlinkage
+
+#define likely(x)			__builtin_expect(!!(x), 1)
+#define unlikely(x)			__builtin_expect(!!(x), 0)
+
+#define barrier()			__asm__ __volatile__("" ::: "memory")
+#define smp_mb()			__sync_synchronize()
+#define smp_rmb()			__sync_synchronize()
+#define smp_wmb()			__sync_synchronize()
+#define mb()				__sync_synchronize()
+#define rmb()				__sync_synchronize()
+#define wmb()				__sync_synchronize()
+
+#define ACCESS_ONCE(x)		(*(volatile typeof(x) *)&(x))
+#define READ_ONCE(x)		ACCESS_ONCE(x)
+#define WRITE_ONCE(x, val)	(ACCESS_ONCE(x) = (val))
+
+#define ARRAY_SIZE(arr)		(sizeof(arr) / sizeof((arr)[0]))
+#define BIT(nr)				(1UL << (nr))
+#define BITS_PER_LONG		(sizeof(long) * 8)
+#define BITS_TO_LONGS(nr)	(((nr) + BITS_PER_LONG - 1) / BITS_PER_LONG)
+#define DIV_ROUND_UP(n, d)	(((n) + (d) - 1) / (d))
+#define roundup(x, y)		((((x) + ((y) - 1)) / (y)) * (y))
+#define rounddown(x, y)		((x) - ((x) % (y)))
+#define __ALIGN_MASK(x, m)	(((x) + (m)) & ~(m))
+#define ALIGN(x, a)			__ALIGN_MASK(x, (typeof(x))(a) - 1)
+#define IS_ALIGNED(x, a)	(((x) & ((typeof(x))(a) - 1)) == 0)
+#define PAGE_SHIFT			12
+#define PAGE_SIZE			(1UL << PAGE_SHIFT)
+#define PAGE_MASK			(~(PAGE_SIZE - 1))
+#define PAGE_ALIGN(x)		ALIGN(x, PAGE_SIZE)
+#define L1_CACHE_BYTES		64
+#define L1_CACHE_ALIGN(x)	ALIGN(x, L1_CACHE_BYTES)
+#define SMP_CACHE_BYTES		L1_CACHE_BYTES
+
+#define container_of(ptr, type, member)	\
+	((type *)((char *)(ptr) - offsetof(type, member)))
+
+#define min(x, y)			({ typeof(x) _x = (x); typeof(y) _y = (y); (_x < _y) ? _x : _y; })
+#define max(x, y)			({ typeof(x) _x = (x); typeof(y) _y = (y); (_x > _y) ? _x : _y; })
+#define min_t(t, x, y)		({ t _x = (x); t _y = (y); (_x < _y) ? _x : _y; })
+#define max_t(t, x, y)		({ t _x = (x); t _y = (y); (_x > _y) ? _x : _y; })
+#define clamp(v, lo, hi)	min(max(v, lo), hi)
+#define clamp_t(t, v, lo, hi)	min_t(t, max_t(t, v, lo), hi)
+#define clamp_val(v, lo, hi)	clamp_t(typeof(v), v, lo, hi)
+#define swap(a, b)			do { typeof(a) _t = (a); (a) = (b); (b) = _t; } while (0)
+#define abs64(x)			llabs(x)
+
+#define U8_MAX				((u8)~0U)
+#define U16_MAX				((u16)~0U)
+#define U32_MAX				((u32)~0U)
+#define S32_MAX				((s32)(U32_MAX>>1))
+#define U64_MAX				((u64)~0ULL)
+
+#define BUILD_BUG_ON(cond)	((void)sizeof(char[1 - 2*!!(cond)]))
+#define BUG()				siw_host_bug(__FILE__, __LINE__)
+#define BUG_ON(cond)		do { if (unlikely(cond)) BUG(); } while (0)
+#define WARN_ON(cond)		({ int _c = !!(cond); if (_c) siw_host_warn(__FILE__, __LINE__); _c; })
+#define WARN_ON_ONCE(cond)	WARN_ON(cond)
+#define WARN(cond, fmt...)	WARN_ON(cond)
+
+#define MINORBITS			20
+#define MINORMASK			((1U << MINORBITS) - 1)
+#define MAJOR(dev)			((unsigned int)((dev) >> MINORBITS))
+#define MINOR(dev)			((unsigned int)((dev) & MINORMASK))
+
+#define MAX_ERRNO			4095
+#define IS_ERR_VALUE(x)		unlikely((unsigned long)(void *)(x) >= (unsigned long)-MAX_ERRNO)
+static inline void *ERR_PTR(long error) { return (void *)error; }
+static inline long PTR_ERR(const void *ptr) { return (long)ptr; }
+static inline bool IS_ERR(const void *ptr) { return IS_ERR_VALUE((unsigned long)ptr); }
+static inline bool IS_ERR_OR_NULL(const void *ptr) { return !ptr || IS_ERR(ptr); }
+
+/* kernel-only errno */
+#ifndef ERESTARTSYS
+#define ERESTARTSYS			512
+#endif
+#ifndef ENOIOCTLCMD
+#define ENOIOCTLCMD			515
+#endif
+#ifndef ENOTSUPP
+#define ENOTSUPP			524
+#endif
+#ifndef EPROBE_DEFER
+#define EPROBE_DEFER		517
+#endif
+#ifndef ERESTART
+#define ERESTART			85
+#endif
+
+#define KERNEL_VERSION(a, b, c)	(((a) << 16) + ((b) << 8) + (c))
+#define LINUX_VERSION_CODE		KERNEL_VERSION(4, 4, 0)
+
+/*
+ * module
+ */
+struct module;
+#define THIS_MODULE			((struct module *)0)
+#define EXPORT_SYMBOL(x)
+#define EXPORT_SYMBOL_GPL(x)
+#define MODULE_LICENSE(x)
+#define MODULE_AUTHOR(x)
+#define MODULE_DESCRIPTION(x)
+#define MODULE_VERSION(x)
+#define MODULE_DEVICE_TABLE(t, n)
+#define MODULE_PARM_DESC(n, d)
+#define module_param(n, t, p)
+#define module_param_named(n, v, t, p)
+#define module_param_string(n, s, l, p)
+#define module_param_array(n, t, c, p)
+#define module_init(fn)
+#define module_exit(fn)
+#define late_initcall(fn)
+/* keep the handler referenced, there is no kernel command line */
+#define __setup(str, fn)	\
+	static int (*__setup_##fn)(char *) __attribute__((unused)) = fn
+#define core_param(n, v, t, p)
+
+/*
+ * print
+ */
+#define KERN_EMERG			"<0>"
+#define KERN_ALERT			"<1>"
+#define KERN_CRIT			"<2>"
+#define KERN_ERR			"<3>"
+#define KERN_WARNING		"<4>"
+#define KERN_NOTICE			"<5>"
+#define KERN_INFO			"<6>"
+#define KERN_DEBUG			"<7>"
+#define KERN_CONT			""
+
+extern int siw_host_printk(const char *fmt, ...) __printf(1, 2);
+#define printk				siw_host_printk
+#define pr_err(fmt, ...)	printk(KERN_ERR fmt, ##__VA_ARGS__)
+#define pr_warn(fmt, ...)	printk(KERN_WARNING fmt, ##__VA_ARGS__)
+#define pr_warning			pr_warn
+#define pr_notice(fmt, ...)	printk(KERN_NOTICE fmt, ##__VA_ARGS__)
+#define pr_info(fmt, ...)	printk(KERN_INFO fmt, ##__VA_ARGS__)
+#define pr_debug(fmt, ...)	printk(KERN_DEBUG fmt, ##__VA_ARGS__)
+#define pr_cont(fmt, ...)	printk(KERN_CONT fmt, ##__VA_ARGS__)
+
+extern void siw_host_bug(const char *file, int line);
+extern void siw_host_warn(const char *file, int line);
+
+#define scnprintf(buf, size, fmt...)	\
+	({ int _n = snprintf(buf, size, ##fmt); (size) ? min_t(int, _n, (int)(size) - 1) : 0; })
+#define vscnprintf(buf, size, fmt, args)	\
+	({ int _n = vsnprintf(buf, size, fmt, args); (size) ? min_t(int, _n, (int)(size) - 1) : 0; })
+
+static inline size_t strlcpy(char *dst, const char *src, size_t size)
+{
+	size_t len = strlen(src);
+
+	if (size) {
+		size_t n = (len >= size) ? size - 1 : len;
+		memcpy(dst, src, n);
+		dst[n] = 0;
+	}
+	return len;
+}
+
+static inline int kstrtoint(const char *s, unsigned int base, int *res)
+{
+	char *end;
+	long v = strtol(s, &end, base);
+
+	if (end == s)
+		return -EINVAL;
+	*res = (int)v;
+	return 0;
+}
+
+static inline int kstrtouint(const char *s, unsigned int base, unsigned int *res)
+{
+	char *end;
+	unsigned long v = strtoul(s, &end, base);
+
+	if (end == s)
+		return -EINVAL;
+	*res = (unsigned int)v;
+	return 0;
+}
+
+#define simple_strtoul		strtoul
+#define simple_strtol		strtol
+
+/*
+ * math
+ */
+static inline u64 div_u64(u64 dividend, u32 divisor) { return dividend / divisor; }
+static inline s64 div_s64(s64 dividend, s32 divisor) { return dividend / divisor; }
+static inline u64 div64_u64(u64 dividend, u64 divisor) { return dividend / divisor; }
+static inline s64 div64_s64(s64 dividend, s64 divisor) { return dividend / divisor; }
+#define do_div(n, base)		({ u32 _rem = (u32)((n) % (base)); (n) = (n) / (base); _rem; })
+
+static inline int ilog2(u64 n) { return 63 - __builtin_clzll(n); }
+static inline int fls(unsigned int x) { return x ? 32 - __builtin_clz(x) : 0; }
+static inline int fls64(u64 x) { return x ? 64 - __builtin_clzll(x) : 0; }
+static inline int ffs_host(int x) { return __builtin_ffs(x); }
+static inline bool is_power_of_2(unsigned long n) { return (n != 0) && ((n & (n - 1)) == 0); }
+static inline unsigned long roundup_pow_of_two(unsigned long n) { return 1UL << fls64(n - 1); }
+static inline unsigned long rounddown_pow_of_two(unsigned long n) { return 1UL << (fls64(n) - 1); }
+static inline int hweight32(u32 w) { return __builtin_popcount(w); }
+
+extern u32 crc32_le(u32 crc, const unsigned char *p, size_t len);
+#define crc32(seed, data, length)	crc32_le(seed, (unsigned char const *)(data), length)
+
+static inline u16 swab16(u16 x) { return __builtin_bswap16(x); }
+static inline u32 swab32(u32 x) { return __builtin_bswap32(x); }
+#define cpu_to_le16(x)		((u16)(x))
+#define cpu_to_le32(x)		((u32)(x))
+#define le16_to_cpu(x)		((u16)(x))
+#define le32_to_cpu(x)		((u32)(x))
+#define cpu_to_be16(x)		swab16(x)
+#define cpu_to_be32(x)		swab32(x)
+#define be16_to_cpu(x)		swab16(x)
+#define be32_to_cpu(x)		swab32(x)
+#define htons(x)			swab16(x)
+#define ntohs(x)			swab16(x)
+#define htonl(x)			swab32(x)
+#define ntohl(x)			swab32(x)
+
+/*
+ * bitops
+ */
+static inline void set_bit(int nr, volatile unsigned long *addr)
+{
+	addr[nr / BITS_PER_LONG] |= 1UL << (nr % BITS_PER_LONG);
+}
+
+static inline void clear_bit(int nr, volatile unsigned long *addr)
+{
+	addr[nr / BITS_PER_LONG] &= ~(1UL << (nr % BITS_PER_LONG));
+}
+
+static inline int test_bit(int nr, const volatile unsigned long *addr)
+{
+	return 1UL & (addr[nr / BITS_PER_LONG] >> (nr % BITS_PER_LONG));
+}
+
+static inline int test_and_set_bit(int nr, volatile unsigned long *addr)
+{
+	int old = test_bit(nr, addr);
+
+	set_bit(nr, addr);
+	return old;
+}
+
+static inline int test_and_clear_bit(int nr, volatile unsigned long *addr)
+{
+	int old = test_bit(nr, addr);
+
+	clear_bit(nr, addr);
+	return old;
+}
+
+#define __set_bit			set_bit
+#define __clear_bit			clear_bit
+
+/*
+ * time
+ */
+#define HZ					100
+#define MSEC_PER_SEC		1000L
+#define USEC_PER_MSEC		1000L
+#define NSEC_PER_USEC		1000L
+#define NSEC_PER_MSEC		1000000L
+#define USEC_PER_SEC		1000000L
+#define NSEC_PER_SEC		1000000000L
+
+extern u64 siw_host_clock_ns(void);
+extern void siw_host_sleep_ns(u64 ns);
+
+#define jiffies				((unsigned long)(siw_host_clock_ns() / (NSEC_PER_SEC / HZ)))
+#define jiffies_64			((u64)jiffies)
+#define INITIAL_JIFFIES		0
+#define MAX_JIFFY_OFFSET	((LONG_MAX >> 1) - 1)
+
+static inline unsigned long msecs_to_jiffies(unsigned int m) { return DIV_ROUND_UP(m, MSEC_PER_SEC / HZ); }
+static inline unsigned long usecs_to_jiffies(unsigned int u) { return DIV_ROUND_UP(u, USEC_PER_SEC / HZ); }
+static inline unsigned int jiffies_to_msecs(unsigned long j) { return j * (MSEC_PER_SEC / HZ); }
+static inline unsigned int jiffies_to_usecs(unsigned long j) { return j * (USEC_PER_SEC / HZ); }
+
+#define time_after(a, b)		((long)((b) - (a)) < 0)
+#define time_before(a, b)		time_after(b, a)
+#define time_after_eq(a, b)		((long)((a) - (b)) >= 0)
+#define time_before_eq(a, b)	time_after_eq(b, a)
+#define time_is_after_jiffies(a)	time_before(jiffies, a)
+#define time_is_before_jiffies(a)	time_after(jiffies, a)
+
+static inline ktime_t ktime_get(void) { return (ktime_t)siw_host_clock_ns(); }
+#define ktime_get_boottime	ktime_get
+#define ktime_get_real		ktime_get
+static inline ktime_t ktime_set(s64 secs, unsigned long nsecs) { return secs * NSEC_PER_SEC + nsecs; }
+static inline ktime_t ktime_sub(ktime_t a, ktime_t b) { return a - b; }
+static inline ktime_t ktime_add(ktime_t a, ktime_t b) { return a + b; }
+static inline ktime_t ktime_add_ns(ktime_t a, u64 ns) { return a + ns; }
+static inline ktime_t ktime_add_us(ktime_t a, u64 us) { return a + us * NSEC_PER_USEC; }
+static inline s64 ktime_to_ns(ktime_t kt) { return kt; }
+static inline s64 ktime_to_us(ktime_t kt) { return kt / NSEC_PER_USEC; }
+static inline s64 ktime_to_ms(ktime_t kt) { return kt / NSEC_PER_MSEC; }
+static inline s64 ktime_us_delta(ktime_t later, ktime_t earlier) { return ktime_to_us(later - earlier); }
+static inline s64 ktime_ms_delta(ktime_t later, ktime_t earlier) { return ktime_to_ms(later - earlier); }
+static inline int ktime_compare(ktime_t a, ktime_t b) { return (a < b) ? -1 : (a > b); }
+static inline bool ktime_after(ktime_t a, ktime_t b) { return a > b; }
+static inline bool ktime_before(ktime_t a, ktime_t b) { return a < b; }
+static inline ktime_t ns_to_ktime(u64 ns) { return ns; }
+#define ktime_get_ns()		((u64)ktime_get())
+
+struct timespec_host {
+	long tv_sec;
+	long tv_nsec;
+};
+#define timespec timespec_host
+
+struct timeval_host {
+	long tv_sec;
+	long tv_usec;
+};
+#define timeval timeval_host
+
+struct rtc_time {
+	int tm_sec;
+	int tm_min;
+	int tm_hour;
+	int tm_mday;
+	int tm_mon;
+	int tm_year;
+	int tm_wday;
+	int tm_yday;
+	int tm_isdst;
+};
+
+static inline void getnstimeofday(struct timespec *ts)
+{
+	u64 ns = siw_host_clock_ns();
+
+	ts->tv_sec = ns / NSEC_PER_SEC;
+	ts->tv_nsec = ns % NSEC_PER_SEC;
+}
+
+static inline void do_gettimeofday(struct timeval *tv)
+{
+	u64 ns = siw_host_clock_ns();
+
+	tv->tv_sec = ns / NSEC_PER_SEC;
+	tv->tv_usec = (ns % NSEC_PER_SEC) / NSEC_PER_USEC;
+}
+
+static inline struct timespec current_kernel_time(void)
+{
+	struct timespec ts;
+
+	getnstimeofday(&ts);
+	return ts;
+}
+
+static inline void rtc_time_to_tm(unsigned long time, struct rtc_time *tm)
+{
+	memset(tm, 0, sizeof(*tm));
+	tm->tm_sec = time % 60;
+	tm->tm_min = (time / 60) % 60;
+	tm->tm_hour = (time / 3600) % 24;
+	tm->tm_mday = 1;
+	tm->tm_year = 70;
+}
+
+static inline void msleep(unsigned int ms) { siw_host_sleep_ns((u64)ms * NSEC_PER_MSEC); }
+static inline unsigned long msleep_interruptible(unsigned int ms) { msleep(ms); return 0; }
+static inline void ssleep(unsigned int s) { msleep(s * 1000); }
+static inline void mdelay(unsigned long ms) { siw_host_sleep_ns((u64)ms * NSEC_PER_MSEC); }
+static inline void udelay(unsigned long us) { siw_host_sleep_ns((u64)us * NSEC_PER_USEC); }
+static inline void ndelay(unsigned long ns) { siw_host_sleep_ns(ns); }
+static inline void usleep_range(unsigned long min, unsigned long max) { udelay(min); }
+
+/*
+ * atomic
+ */
+typedef struct {
+	int counter;
+} atomic_t;
+
+typedef struct {
+	long long counter;
+} atomic64_t;
+
+#define ATOMIC_INIT(i)			{ (i) }
+#define atomic_read(v)			READ_ONCE((v)->counter)
+#define atomic_set(v, i)		WRITE_ONCE((v)->counter, (i))
+#define atomic_inc(v)			((void)__sync_add_and_fetch(&(v)->counter, 1))
+#define atomic_dec(v)			((void)__sync_sub_and_fetch(&(v)->counter, 1))
+#define atomic_add(i, v)		((void)__sync_add_and_fetch(&(v)->counter, (i)))
+#define atomic_sub(i, v)		((void)__sync_sub_and_fetch(&(v)->counter, (i)))
+#define atomic_inc_return(v)	__sync_add_and_fetch(&(v)->counter, 1)
+#define atomic_dec_return(v)	__sync_sub_and_fetch(&(v)->counter, 1)
+#define atomic_add_return(i, v)	__sync_add_and_fetch(&(v)->counter, (i))
+#define atomic_dec_and_test(v)	(atomic_dec_return(v) == 0)
+#define atomic_inc_and_test(v)	(atomic_inc_return(v) == 0)
+#define atomic_xchg(v, n)		__sync_lock_test_and_set(&(v)->counter, (n))
+#define atomic_cmpxchg(v, o, n)	__sync_val_compare_and_swap(&(v)->counter, (o), (n))
+#define atomic64_read(v)		READ_ONCE((v)->counter)
+#define atomic64_set(v, i)		WRITE_ONCE((v)->counter, (i))
+#define atomic64_add(i, v)		((void)__sync_add_and_fetch(&(v)->counter, (i)))
+#define atomic64_inc(v)			atomic64_add(1, v)
+
+/*
+ * locks
+ */
+struct lock_class_key {
+	int dummy;
+};
+
+struct mutex {
+	int locked;
+	int init;
+	const char *name;
+};
+
+#define __MUTEX_INITIALIZER(n)	{ .locked = 0, .init = 1, .name = #n }
+#define DEFINE_MUTEX(n)			struct mutex n = __MUTEX_INITIALIZER(n)
+
+extern void siw_host_mutex_init(struct mutex *lock, const char *name);
+extern void siw_host_mutex_lock(struct mutex *lock, const char *file, int line);
+extern int siw_host_mutex_trylock(struct mutex *lock);
+extern void siw_host_mutex_unlock(struct mutex *lock, const char *file, int line);
+
+#define mutex_init(l)			siw_host_mutex_init(l, #l)
+#define mutex_destroy(l)		do { (l)->init = 0; } while (0)
+#define mutex_lock(l)			siw_host_mutex_lock(l, __FILE__, __LINE__)
+#define mutex_lock_interruptible(l)	({ mutex_lock(l); 0; })
+#define mutex_lock_nested(l, s)	mutex_lock(l)
+#define mutex_trylock(l)		siw_host_mutex_trylock(l)
+#define mutex_unlock(l)			siw_host_mutex_unlock(l, __FILE__, __LINE__)
+#define mutex_is_locked(l)		((l)->locked)
+
+typedef struct {
+	int locked;
+} spinlock_t;
+
+#define __SPIN_LOCK_UNLOCKED(n)	{ 0 }
+#define DEFINE_SPINLOCK(n)		spinlock_t n = __SPIN_LOCK_UNLOCKED(n)
+#define spin_lock_init(l)		do { (l)->locked = 0; } while (0)
+#define spin_lock(l)			do { (l)->locked++; } while (0)
+#define spin_unlock(l)			do { (l)->locked--; } while (0)
+#define spin_lock_bh			spin_lock
+#define spin_unlock_bh			spin_unlock
+#define spin_lock_irq			spin_lock
+#define spin_unlock_irq			spin_unlock
+#define spin_lock_irqsave(l, f)	do { (f) = 0; spin_lock(l); } while (0)
+#define spin_unlock_irqrestore(l, f)	do { (void)(f); spin_unlock(l); } while (0)
+
+#define local_irq_save(f)		do { (f) = 0; } while (0)
+#define local_irq_restore(f)	do { (void)(f); } while (0)
+#define preempt_disable()		do { } while (0)
+#define preempt_enable()		do { } while (0)
+
+/*
+ * list
+ */
+struct list_head {
+	struct list_head *next, *prev;
+};
+
+#define LIST_HEAD_INIT(n)		{ &(n), &(n) }
+#define LIST_HEAD(n)			struct list_head n = LIST_HEAD_INIT(n)
+
+static inline void INIT_LIST_HEAD(struct list_head *list)
+{
+	list->next = list;
+	list->prev = list;
+}
+
+static inline void __list_add(struct list_head *item,
+			struct list_head *prev, struct list_head *next)
+{
+	next->prev = item;
+	item->next = next;
+	item->prev = prev;
+	prev->next = item;
+}
+
+static inline void list_add(struct list_head *item, struct list_head *head)
+{
+	__list_add(item, head, head->next);
+}
+
+static inline void list_add_tail(struct list_head *item, struct list_head *head)
+{
+	__list_add(item, head->prev, head);
+}
+
+static inline void list_del_init(struct list_head *entry)
+{
+	entry->next->prev = entry->prev;
+	entry->prev->next = entry->next;
+	INIT_LIST_HEAD(entry);
+}
+
+#define list_del				list_del_init
+
+static inline int list_empty(const struct list_head *head)
+{
+	return head->next == head;
+}
+
+#define list_entry(ptr, type, member)	container_of(ptr, type, member)
+#define list_first_entry(ptr, type, member)	list_entry((ptr)->next, type, member)
+#define list_for_each_entry(pos, head, member)	\
+	for (pos = list_entry((head)->next, typeof(*pos), member);	\
+		&pos->member != (head);	\
+		pos = list_entry(pos->member.next, typeof(*pos), member))
+#define list_for_each_entry_safe(pos, n, head, member)	\
+	for (pos = list_entry((head)->next, typeof(*pos), member),	\
+		n = list_entry(pos->member.next, typeof(*pos), member);	\
+		&pos->member != (head);	\
+		pos = n, n = list_entry(n->member.next, typeof(*n), member))
+
+/*
+ * wait queue, completion
+ */
+typedef struct {
+	int dummy;
+} wait_queue_head_t;
+
+#define init_waitqueue_head(q)	do { (void)(q); } while (0)
+#define DECLARE_WAIT_QUEUE_HEAD(n)	wait_queue_head_t n = { 0 }
+#define wake_up(q)				do { (void)(q); } while (0)
+#define wake_up_all(q)			wake_up(q)
+#define wake_up_interruptible(q)	wake_up(q)
+#define wake_up_interruptible_all(q)	wake_up(q)
+/* never blocks : the condition is checked once */
+#define wait_event(q, cond)		do { (void)(cond); } while (0)
+#define wait_event_interruptible(q, cond)	({ (void)(cond); 0; })
+#define wait_event_timeout(q, cond, t)	({ (cond) ? (long)(t) : 0L; })
+#define wait_event_interruptible_timeout(q, cond, t)	wait_event_timeout(q, cond, t)
+
+struct completion {
+	unsigned int done;
+};
+
+#define init_completion(c)		do { (c)->done = 0; } while (0)
+#define reinit_completion(c)	init_completion(c)
+#define DECLARE_COMPLETION_ONSTACK(n)	struct completion n = { 0 }
+#define complete(c)				do { (c)->done++; } while (0)
+#define complete_all(c)			do { (c)->done = UINT_MAX / 2; } while (0)
+#define wait_for_completion(c)	do { (void)(c); } while (0)
+#define wait_for_completion_timeout(c, t)	((c)->done ? (unsigned long)(t) : 0UL)
+#define completion_done(c)		((c)->done)
+
+/*
+ * memory
+ */
+#define GFP_KERNEL			0x01u
+#define GFP_ATOMIC			0x02u
+#define GFP_DMA				0x04u
+#define GFP_NOWAIT			0x08u
+#define __GFP_ZERO			0x10u
+#define __GFP_NOWARN		0x20u
+
+static inline void *kmalloc(size_t size, gfp_t flags)
+{
+	return (flags & __GFP_ZERO) ? calloc(1, size ? size : 1) : malloc(size ? size : 1);
+}
+#define kzalloc(s, f)			kmalloc(s, (f) | __GFP_ZERO)
+#define kcalloc(n, s, f)		kzalloc((n) * (s), f)
+#define kmalloc_array(n, s, f)	kmalloc((n) * (s), f)
+#define kfree(p)				free((void *)(p))
+#define kvfree(p)				free((void *)(p))
+#define vmalloc(s)				malloc((s) ? (s) : 1)
+#define vzalloc(s)				calloc(1, (s) ? (s) : 1)
+#define vfree(p)				free((void *)(p))
+#define devm_kzalloc(d, s, f)	kzalloc(s, f)
+#define devm_kmalloc(d, s, f)	kmalloc(s, f)
+#define devm_kfree(d, p)		kfree(p)
+#define kstrdup(s, f)			strdup(s)
+#define kmemdup(s, l, f)		({ void *_p = malloc(l); if (_p) memcpy(_p, s, l); _p; })
+
+/*
+ * uaccess
+ */
+#define VERIFY_READ			0
+#define VERIFY_WRITE		1
+#define access_ok(t, a, s)	1
+#define copy_from_user(to, from, n)	({ memcpy(to, (const void *)(from), n); 0UL; })
+#define copy_to_user(to, from, n)	({ memcpy((void *)(to), from, n); 0UL; })
+#define get_user(x, p)		({ (x) = *(p); 0; })
+#define put_user(x, p)		({ *(p) = (x); 0; })
+
+typedef struct {
+	unsigned long seg;
+} mm_segment_t;
+
+#define KERNEL_DS			((mm_segment_t){ 0 })
+#define USER_DS				((mm_segment_t){ 1 })
+#define get_fs()			KERNEL_DS
+#define set_fs(x)			do { (void)(x); } while (0)
+#define get_ds()			KERNEL_DS
+
+/*
+ * task, kthread
+ */
+#define TASK_COMM_LEN		16
+
+struct task_struct {
+	int pid;
+	char comm[TASK_COMM_LEN];
+	int (*fn)(void *data);
+	void *data;
+	int stop;
+};
+
+extern struct task_struct *siw_host_current;
+#define current				siw_host_current
+
+#define TASK_RUNNING			0
+#define TASK_INTERRUPTIBLE		1
+#define TASK_UNINTERRUPTIBLE	2
+#define MAX_SCHEDULE_TIMEOUT	LONG_MAX
+
+#define set_current_state(s)	do { (void)(s); } while (0)
+#define __set_current_state(s)	set_current_state(s)
+#define schedule()				do { } while (0)
+#define cond_resched()			do { } while (0)
+#define signal_pending(t)		0
+#define schedule_timeout(t)		({ msleep(jiffies_to_msecs(t)); 0L; })
+#define schedule_timeout_interruptible(t)	schedule_timeout(t)
+
+extern struct task_struct *siw_host_kthread_create(int (*fn)(void *data),
+				void *data, const char *name);
+extern int kthread_stop(struct task_struct *k);
+extern bool kthread_should_stop(void);
+
+#define kthread_create(fn, data, fmt...)	siw_host_kthread_create(fn, data, #fn)
+#define kthread_run(fn, data, fmt...)		siw_host_kthread_create(fn, data, #fn)
+static inline int wake_up_process(struct task_struct *t) { return 0; }
+
+/*
+ * workqueue
+ */
+struct work_struct;
+typedef void (*work_func_t)(struct work_struct *work);
+
+struct work_struct {
+	struct list_head entry;
+	work_func_t func;
+	int pending;
+	u64 due_ns;
+};
+
+struct timer_list {
+	unsigned long expires;
+	void (*function)(unsigned long data);
+	unsigned long data;
+};
+
+struct delayed_work {
+	struct work_struct work;
+	struct timer_list timer;
+};
+
+struct workqueue_struct {
+	char name[32];
+};
+
+#define INIT_WORK(w, f)		\
+	do { INIT_LIST_HEAD(&(w)->entry); (w)->func = (f); (w)->pending = 0; } while (0)
+#define INIT_DELAYED_WORK(w, f)		INIT_WORK(&(w)->work, f)
+#define INIT_DEFERRABLE_WORK(w, f)	INIT_DELAYED_WORK(w, f)
+#define DECLARE_WORK(n, f)			struct work_struct n = { .entry = LIST_HEAD_INIT(n.entry), .func = (f) }
+#define DECLARE_DELAYED_WORK(n, f)	struct delayed_work n = { .work = { .entry = LIST_HEAD_INIT(n.work.entry), .func = (f) } }
+
+static inline struct delayed_work *to_delayed_work(struct work_struct *work)
+{
+	return container_of(work, struct delayed_work, work);
+}
+
+#define work_pending(w)				((w)->pending)
+#define delayed_work_pending(w)		work_pending(&(w)->work)
+
+extern struct workqueue_struct *siw_host_alloc_wq(const char *name);
+extern void destroy_workqueue(struct workqueue_struct *wq);
+extern bool queue_work(struct workqueue_struct *wq, struct work_struct *work);
+extern bool queue_delayed_work(struct workqueue_struct *wq,
+				struct delayed_work *dwork, unsigned long delay);
+extern bool mod_delayed_work(struct workqueue_struct *wq,
+				struct delayed_work *dwork, unsigned long delay);
+extern bool cancel_work_sync(struct work_struct *work);
+extern bool cancel_delayed_work(struct delayed_work *dwork);
+extern bool cancel_delayed_work_sync(struct delayed_work *dwork);
+extern bool flush_work(struct work_struct *work);
+extern bool flush_delayed_work(struct delayed_work *dwork);
+extern void flush_workqueue(struct workqueue_struct *wq);
+
+#define create_singlethread_workqueue(n)	siw_host_alloc_wq(n)
+#define create_workqueue(n)					siw_host_alloc_wq(n)
+#define alloc_workqueue(fmt, f, m, args...)	siw_host_alloc_wq(fmt)
+#define alloc_ordered_workqueue(fmt, f, args...)	siw_host_alloc_wq(fmt)
+#define WQ_UNBOUND			0x02
+#define WQ_HIGHPRI			0x10
+#define WQ_MEM_RECLAIM		0x08
+#define WQ_FREEZABLE		0x04
+
+#define schedule_work(w)				queue_work(NULL, w)
+#define schedule_delayed_work(w, d)		queue_delayed_work(NULL, w, d)
+#define flush_scheduled_work()			flush_workqueue(NULL)
+
+/*
+ * kobject, sysfs
+ */
+struct kobject;
+struct attribute {
+	const char *name;
+	umode_t mode;
+};
+
+struct sysfs_ops {
+	ssize_t (*show)(struct kobject *kobj, struct attribute *attr, char *buf);
+	ssize_t (*store)(struct kobject *kobj, struct attribute *attr,
+				const char *buf, size_t count);
+};
+
+struct kobj_type {
+	void (*release)(struct kobject *kobj);
+	const struct sysfs_ops *sysfs_ops;
+	struct attribute **default_attrs;
+};
+
+struct kobject {
+	const char *name;
+	struct kobject *parent;
+	struct kobj_type *ktype;
+	int state_initialized;
+};
+
+struct attribute_group {
+	const char *name;
+	struct attribute **attrs;
+};
+
+struct file;
+struct bin_attribute {
+	struct attribute attr;
+	size_t size;
+	void *private;
+	ssize_t (*read)(struct file *filp, struct kobject *kobj,
+			struct bin_attribute *attr, char *buf, loff_t off, size_t count);
+	ssize_t (*write)(struct file *filp, struct kobject *kobj,
+			struct bin_attribute *attr, char *buf, loff_t off, size_t count);
+};
+
+#define S_IRUGO				(S_IRUSR | S_IRGRP | S_IROTH)
+#define S_IWUGO				(S_IWUSR | S_IWGRP | S_IWOTH)
+#define S_IRWXUGO			(S_IRWXU | S_IRWXG | S_IRWXO)
+#ifndef S_IRUSR
+#define S_IRUSR				00400
+#define S_IWUSR				00200
+#define S_IXUSR				00100
+#define S_IRWXU				00700
+#define S_IRGRP				00040
+#define S_IWGRP				00020
+#define S_IXGRP				00010
+#define S_IRWXG				00070
+#define S_IROTH				00004
+#define S_IWOTH				00002
+#define S_IXOTH				00001
+#define S_IRWXO				00007
+#endif
+
+enum kobject_action {
+	KOBJ_ADD,
+	KOBJ_REMOVE,
+	KOBJ_CHANGE,
+	KOBJ_MOVE,
+	KOBJ_ONLINE,
+	KOBJ_OFFLINE,
+};
+
+extern int kobject_init_and_add(struct kobject *kobj, struct kobj_type *ktype,
+				struct kobject *parent, const char *fmt, ...);
+extern void kobject_del(struct kobject *kobj);
+extern void kobject_put(struct kobject *kobj);
+extern int kobject_uevent_env(struct kobject *kobj, enum kobject_action action,
+				char *envp[]);
+extern int kobject_uevent(struct kobject *kobj, enum kobject_action action);
+extern int sysfs_create_group(struct kobject *kobj, const struct attribute_group *grp);
+extern void sysfs_remove_group(struct kobject *kobj, const struct attribute_group *grp);
+extern int sysfs_create_bin_file(struct kobject *kobj, const struct bin_attribute *attr);
+extern void sysfs_remove_bin_file(struct kobject *kobj, const struct bin_attribute *attr);
+extern int sysfs_create_link(struct kobject *kobj, struct kobject *target, const char *name);
+extern void sysfs_remove_link(struct kobject *kobj, const char *name);
+#define sysfs_attr_init(a)		do { } while (0)
+
+#define __ATTR(_name, _mode, _show, _store) {	\
+	.attr = { .name = #_name, .mode = (_mode) },	\
+	.show = _show,	\
+	.store = _store,	\
+}
+
+/*
+ * device
+ */
+struct device;
+struct device_node;
+struct device_driver {
+	const char *name;
+	struct module *owner;
+	const struct of_device_id *of_match_table;
+	const struct dev_pm_ops *pm;
+};
+
+struct dev_pm_ops {
+	int (*suspend)(struct device *dev);
+	int (*resume)(struct device *dev);
+};
+
+struct bus_type {
+	const char *name;
+	const char *dev_name;
+};
+
+struct class {
+	const char *name;
+};
+
+struct device {
+	struct device *parent;
+	struct kobject kobj;
+	const char *init_name;
+	char name[64];
+	struct device_driver *driver;
+	struct device_node *of_node;
+	void *platform_data;
+	void *driver_data;
+	struct bus_type *bus;
+	dev_t devt;
+	u64 *dma_mask;
+	u64 coherent_dma_mask;
+	void (*release)(struct device *dev);
+};
+
+static inline const char *dev_name(const struct device *dev)
+{
+	return (dev) ? dev->name : "(null)";
+}
+
+static inline void *dev_get_drvdata(const struct device *dev) { return dev->driver_data; }
+static inline void dev_set_drvdata(struct device *dev, void *data) { dev->driver_data = data; }
+static inline void *dev_get_platdata(const struct device *dev) { return dev->platform_data; }
+static inline int dev_set_name(struct device *dev, const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vsnprintf(dev->name, sizeof(dev->name), fmt, args);
+	va_end(args);
+	return 0;
+}
+
+#define get_device(d)		(d)
+#define put_device(d)		do { (void)(d); } while (0)
+#define device_init_wakeup(d, v)	({ (void)(d); 0; })
+#define device_may_wakeup(d)	0
+#define device_create_file(d, a)	0
+#define device_remove_file(d, a)	do { } while (0)
+
+extern void siw_host_dev_printk(const char *level, const struct device *dev,
+				const char *fmt, ...) __printf(3, 4);
+#define dev_err(d, fmt, ...)	siw_host_dev_printk(KERN_ERR, d, fmt, ##__VA_ARGS__)
+#define dev_warn(d, fmt, ...)	siw_host_dev_printk(KERN_WARNING, d, fmt, ##__VA_ARGS__)
+#define dev_info(d, fmt, ...)	siw_host_dev_printk(KERN_INFO, d, fmt, ##__VA_ARGS__)
+#define dev_dbg(d, fmt, ...)	siw_host_dev_printk(KERN_DEBUG, d, fmt, ##__VA_ARGS__)
+
+extern int bus_register(struct bus_type *bus);
+extern void bus_unregister(struct bus_type *bus);
+extern int subsys_system_register(struct bus_type *subsys,
+				const struct attribute_group **groups);
+extern int device_register(struct device *dev);
+extern void device_unregister(struct device *dev);
+
+/*
+ * dma
+ */
+extern void *dma_alloc_coherent(struct device *dev, size_t size,
+				dma_addr_t *dma_handle, gfp_t flag);
+extern void dma_free_coherent(struct device *dev, size_t size,
+				void *cpu_addr, dma_addr_t dma_handle);
+#define DMA_BIT_MASK(n)		(((n) == 64) ? ~0ULL : ((1ULL << (n)) - 1))
+#define dma_set_coherent_mask(d, m)	0
+#define dma_set_mask(d, m)			0
+
+/*
+ * irq
+ */
+typedef int irqreturn_t;
+typedef irqreturn_t (*irq_handler_t)(int irq, void *dev_id);
+
+#define IRQ_NONE				0
+#define IRQ_HANDLED				1
+#define IRQ_WAKE_THREAD			2
+
+#define IRQF_TRIGGER_NONE		0x00000000
+#define IRQF_TRIGGER_RISING		0x00000001
+#define IRQF_TRIGGER_FALLING	0x00000002
+#define IRQF_TRIGGER_HIGH		0x00000004
+#define IRQF_TRIGGER_LOW		0x00000008
+#define IRQF_TRIGGER_MASK		0x0000000F
+#define IRQF_SHARED				0x00000080
+#define IRQF_ONESHOT			0x00002000
+#define IRQF_NO_SUSPEND			0x00004000
+#define IRQF_NO_THREAD			0x00010000
+#define IRQ_TYPE_NONE			0
+#define IRQ_TYPE_SENSE_MASK		0x0000000f
+#define IRQ_TYPE_EDGE_FALLING	IRQF_TRIGGER_FALLING
+#define IRQ_TYPE_LEVEL_LOW		IRQF_TRIGGER_LOW
+
+extern int request_threaded_irq(unsigned int irq, irq_handler_t handler,
+				irq_handler_t thread_fn, unsigned long flags,
+				const char *name, void *dev);
+extern void free_irq(unsigned int irq, void *dev_id);
+extern void enable_irq(unsigned int irq);
+extern void disable_irq(unsigned int irq);
+extern void disable_irq_nosync(unsigned int irq);
+static inline int enable_irq_wake(unsigned int irq) { return 0; }
+static inline int disable_irq_wake(unsigned int irq) { return 0; }
+static inline int irq_set_irq_wake(unsigned int irq, unsigned int on) { return 0; }
+static inline int irq_set_irq_type(unsigned int irq, unsigned int type) { return 0; }
+#define synchronize_irq(irq)		do { } while (0)
+#define in_interrupt()				0
+
+/* no irq_desc on the host, pending state is not emulated */
+struct irq_desc {
+	spinlock_t lock;
+	unsigned int core_internal_state__do_not_mess_with_it;
+};
+#define IRQS_PENDING				0x00000200
+#define irq_to_desc(irq)			((struct irq_desc *)NULL)
+#define raw_spin_lock_irqsave		spin_lock_irqsave
+#define raw_spin_unlock_irqrestore	spin_unlock_irqrestore
+#define irqs_disabled()				0
+
+/*
+ * gpio, pinctrl, regulator
+ */
+enum of_gpio_flags {
+	OF_GPIO_ACTIVE_LOW = 0x1,
+};
+
+#define GPIOF_DIR_OUT		(0 << 0)
+#define GPIOF_DIR_IN		(1 << 0)
+#define GPIOF_INIT_LOW		(0 << 1)
+#define GPIOF_INIT_HIGH		(1 << 1)
+#define GPIOF_OUT_INIT_LOW	(GPIOF_DIR_OUT | GPIOF_INIT_LOW)
+#define GPIOF_OUT_INIT_HIGH	(GPIOF_DIR_OUT | GPIOF_INIT_HIGH)
+#define GPIOF_IN			(GPIOF_DIR_IN)
+
+static inline bool gpio_is_valid(int gpio) { return gpio >= 0; }
+extern int gpio_request(unsigned int gpio, const char *label);
+extern void gpio_free(unsigned int gpio);
+extern int gpio_direction_input(unsigned int gpio);
+extern int gpio_direction_output(unsigned int gpio, int value);
+extern int gpio_get_value(unsigned int gpio);
+extern void gpio_set_value(unsigned int gpio, int value);
+extern int gpio_to_irq(unsigned int gpio);
+#define gpio_cansleep(g)			0
+#define gpio_get_value_cansleep		gpio_get_value
+#define gpio_set_value_cansleep		gpio_set_value
+#define gpio_export(g, d)			0
+
+struct pinctrl;
+struct pinctrl_state;
+extern struct pinctrl *devm_pinctrl_get(struct device *dev);
+extern void devm_pinctrl_put(struct pinctrl *p);
+extern struct pinctrl_state *pinctrl_lookup_state(struct pinctrl *p, const char *name);
+extern int pinctrl_select_state(struct pinctrl *p, struct pinctrl_state *s);
+
+struct regulator;
+extern struct regulator *regulator_get(struct device *dev, const char *id);
+extern void regulator_put(struct regulator *regulator);
+extern int regulator_enable(struct regulator *regulator);
+extern int regulator_disable(struct regulator *regulator);
+extern int regulator_is_enabled(struct regulator *regulator);
+extern int regulator_set_voltage(struct regulator *regulator, int min_uV, int max_uV);
+#define devm_regulator_get		regulator_get
+#define devm_regulator_put		regulator_put
+
+/*
+ * of
+ */
+struct device_node {
+	const char *name;
+	const char *full_name;
+};
+
+struct of_device_id {
+	char name[32];
+	char type[32];
+	char compatible[128];
+	const void *data;
+};
+
+#define of_match_ptr(p)		(p)
+extern int of_property_read_u32(const struct device_node *np,
+				const char *propname, u32 *out_value);
+extern int of_property_read_string(const struct device_node *np,
+				const char *propname, const char **out_string);
+extern int of_property_read_string_index(const struct device_node *np,
+				const char *propname, int index, const char **output);
+extern int of_property_count_strings(const struct device_node *np,
+				const char *propname);
+extern int of_get_named_gpio_flags(struct device_node *np,
+				const char *list_name, int index, enum of_gpio_flags *flags);
+#define of_get_named_gpio(np, n, i)		of_get_named_gpio_flags(np, n, i, NULL)
+extern int of_device_is_compatible(const struct device_node *device,
+				const char *compat);
+extern const struct of_device_id *of_match_device(const struct of_device_id *matches,
+				const struct device *dev);
+
+/*
+ * firmware
+ */
+struct firmware {
+	size_t size;
+	const u8 *data;
+	void *priv;
+};
+
+extern int request_firmware(const struct firmware **fw, const char *name,
+				struct device *device);
+extern void release_firmware(const struct firmware *fw);
+
+/*
+ * file
+ */
+struct inode {
+	void *i_private;
+	loff_t i_size;
+	umode_t i_mode;
+	struct timespec i_mtime;
+};
+
+struct dentry {
+	struct inode *d_inode;
+};
+
+struct path {
+	struct dentry *dentry;
+};
+
+struct file_operations;
+struct file {
+	struct path f_path;
+	loff_t f_pos;
+	void *private_data;
+	unsigned int f_flags;
+	fmode_t f_mode;
+	const struct file_operations *f_op;
+	struct inode *f_inode;
+};
+
+struct kstat {
+	loff_t size;
+	umode_t mode;
+	struct timespec mtime;
+};
+
+struct vm_area_struct {
+	unsigned long vm_start;
+	unsigned long vm_end;
+	unsigned long vm_pgoff;
+	unsigned long vm_flags;
+};
+
+struct poll_table_struct;
+typedef struct poll_table_struct poll_table;
+
+struct file_operations {
+	struct module *owner;
+	loff_t (*llseek)(struct file *, loff_t, int);
+	ssize_t (*read)(struct file *, char __user *, size_t, loff_t *);
+	ssize_t (*write)(struct file *, const char __user *, size_t, loff_t *);
+	unsigned int (*poll)(struct file *, struct poll_table_struct *);
+	long (*unlocked_ioctl)(struct file *, unsigned int, unsigned long);
+	long (*compat_ioctl)(struct file *, unsigned int, unsigned long);
+	int (*mmap)(struct file *, struct vm_area_struct *);
+	int (*open)(struct inode *, struct file *);
+	int (*release)(struct inode *, struct file *);
+};
+
+#define file_inode(f)		((f)->f_inode)
+#define i_size_read(i)		((i)->i_size)
+#define PATH_MAX_HOST		4096
+#define __getname()			((char *)kmalloc(PATH_MAX_HOST, GFP_KERNEL))
+#define __putname(name)		kfree(name)
+extern struct file *filp_open(const char *filename, int flags, umode_t mode);
+extern int filp_close(struct file *filp, void *id);
+extern ssize_t vfs_read(struct file *file, char __user *buf, size_t count, loff_t *pos);
+extern ssize_t vfs_write(struct file *file, const char __user *buf, size_t count, loff_t *pos);
+extern int vfs_stat(const char __user *name, struct kstat *stat);
+extern loff_t vfs_llseek(struct file *file, loff_t offset, int whence);
+extern ssize_t kernel_read(struct file *file, loff_t offset, char *addr, unsigned long count);
+extern ssize_t kernel_write(struct file *file, const char *buf, size_t count, loff_t pos);
+#define no_llseek			NULL
+#define nonseekable_open(i, f)	0
+
+/*
+ * notifier
+ */
+struct notifier_block;
+typedef int (*notifier_fn_t)(struct notifier_block *nb,
+			unsigned long action, void *data);
+
+struct notifier_block {
+	notifier_fn_t notifier_call;
+	struct notifier_block *next;
+	int priority;
+};
+
+struct blocking_notifier_head {
+	struct mutex rwsem;
+	struct notifier_block *head;
+};
+
+struct atomic_notifier_head {
+	spinlock_t lock;
+	struct notifier_block *head;
+};
+
+#define NOTIFY_DONE			0x0000
+#define NOTIFY_OK			0x0001
+#define NOTIFY_STOP_MASK	0x8000
+#define NOTIFY_BAD			(NOTIFY_STOP_MASK|0x0002)
+#define NOTIFY_STOP			(NOTIFY_OK|NOTIFY_STOP_MASK)
+
+#define BLOCKING_NOTIFIER_HEAD(n)	struct blocking_notifier_head n = { .head = NULL }
+#define ATOMIC_NOTIFIER_HEAD(n)		struct atomic_notifier_head n = { .head = NULL }
+#define BLOCKING_INIT_NOTIFIER_HEAD(n)	do { (n)->head = NULL; } while (0)
+#define ATOMIC_INIT_NOTIFIER_HEAD(n)	do { (n)->head = NULL; } while (0)
+
+extern int siw_host_notifier_register(struct notifier_block **head,
+				struct notifier_block *nb);
+extern int siw_host_notifier_unregister(struct notifier_block **head,
+				struct notifier_block *nb);
+extern int siw_host_notifier_call(struct notifier_block **head,
+				unsigned long val, void *v);
+
+#define blocking_notifier_chain_register(nh, nb)	siw_host_notifier_register(&(nh)->head, nb)
+#define blocking_notifier_chain_unregister(nh, nb)	siw_host_notifier_unregister(&(nh)->head, nb)
+#define blocking_notifier_call_chain(nh, v, d)		siw_host_notifier_call(&(nh)->head, v, d)
+#define atomic_notifier_chain_register(nh, nb)		siw_host_notifier_register(&(nh)->head, nb)
+#define atomic_notifier_chain_unregister(nh, nb)	siw_host_notifier_unregister(&(nh)->head, nb)
+#define atomic_notifier_call_chain(nh, v, d)		siw_host_notifier_call(&(nh)->head, v, d)
+
+/*
+ * platform device
+ */
+struct resource {
+	u64 start;
+	u64 end;
+	const char *name;
+	unsigned long flags;
+};
+
+struct platform_device {
+	const char *name;
+	int id;
+	struct device dev;
+};
+
+struct platform_driver {
+	int (*probe)(struct platform_device *pdev);
+	int (*remove)(struct platform_device *pdev);
+	void (*shutdown)(struct platform_device *pdev);
+	int (*suspend)(struct platform_device *pdev, int state);
+	int (*resume)(struct platform_device *pdev);
+	struct device_driver driver;
+};
+
+#define to_platform_device(x)	container_of((x), struct platform_device, dev)
+static inline void *platform_get_drvdata(const struct platform_device *pdev) { return dev_get_drvdata(&pdev->dev); }
+static inline void platform_set_drvdata(struct platform_device *pdev, void *data) { dev_set_drvdata(&pdev->dev, data); }
+extern struct platform_device *platform_device_alloc(const char *name, int id);
+extern int platform_device_add(struct platform_device *pdev);
+extern int platform_device_add_data(struct platform_device *pdev, const void *data, size_t size);
+extern void platform_device_put(struct platform_device *pdev);
+extern void platform_device_unregister(struct platform_device *pdev);
+extern int platform_driver_register(struct platform_driver *drv);
+extern void platform_driver_unregister(struct platform_driver *drv);
+
+/*
+ * i2c, spi (bus headers only, the host bus replaces both drivers)
+ */
+struct i2c_client {
+	unsigned short flags;
+	unsigned short addr;
+	char name[32];
+	struct device dev;
+	int irq;
+};
+
+struct i2c_device_id {
+	char name[32];
+	unsigned long driver_data;
+};
+
+struct i2c_driver {
+	int (*probe)(struct i2c_client *client, const struct i2c_device_id *id);
+	int (*remove)(struct i2c_client *client);
+	struct device_driver driver;
+	const struct i2c_device_id *id_table;
+};
+
+struct i2c_msg {
+	u16 addr;
+	u16 flags;
+	u16 len;
+	u8 *buf;
+};
+#define I2C_M_RD			0x0001
+
+struct spi_device {
+	struct device dev;
+	u32 max_speed_hz;
+	u8 chip_select;
+	u8 bits_per_word;
+	u16 mode;
+	int irq;
+	char modalias[32];
+};
+
+struct spi_device_id {
+	char name[32];
+	unsigned long driver_data;
+};
+
+struct spi_driver {
+	const struct spi_device_id *id_table;
+	int (*probe)(struct spi_device *spi);
+	int (*remove)(struct spi_device *spi);
+	struct device_driver driver;
+};
+
+#define SPI_CPHA			0x01
+#define SPI_CPOL			0x02
+#define SPI_MODE_0			(0|0)
+#define SPI_MODE_1			(0|SPI_CPHA)
+#define SPI_MODE_2			(SPI_CPOL|0)
+#define SPI_MODE_3			(SPI_CPOL|SPI_CPHA)
+
+/*
+ * input
+ */
+#include <siw_host_input.h>
+
+/*
+ * pm
+ */
+typedef struct pm_message {
+	int event;
+} pm_message_t;
+
+struct pm_qos_request {
+	int dummy;
+};
+
+#define PM_QOS_CPU_DMA_LATENCY	1
+#define PM_QOS_DEFAULT_VALUE	(-1)
+#define pm_qos_add_request(r, c, v)		do { } while (0)
+#define pm_qos_update_request(r, v)		do { } while (0)
+#define pm_qos_remove_request(r)		do { } while (0)
+
+#define pm_runtime_enable(d)	do { } while (0)
+#define pm_runtime_disable(d)	do { } while (0)
+
+/*
+ * misc
+ */
+#define capable(c)			1
+#define CAP_SYS_ADMIN		21
+#define SZ_1K				0x400
+#define SZ_4K				0x1000
+#define SZ_64K				0x10000
+#define num_online_cpus()	1
+#define smp_processor_id()	0
+#define raw_smp_processor_id()	0
+#define cpu_relax()			do { } while (0)
+#define dump_stack()		do { } while (0)
+#define might_sleep()		do { } while (0)
+#define prefetch(x)			do { (void)(x); } while (0)
+
+struct siw_host_async_cookie;
+typedef u64 async_cookie_t;
+typedef void (*async_func_t)(void *data, async_cookie_t cookie);
+extern async_cookie_t async_schedule(async_func_t func, void *data);
+#define async_synchronize_full()	do { } while (0)
+
+extern unsigned long get_seconds(void);
+
+#define in_aton(s)			0
+
+/*
+ * debugfs, seq_file
+ */
+struct seq_file {
+	char *buf;
+	size_t size;
+	size_t count;
+	void *private;
+	int (*show)(struct seq_file *m, void *v);
+};
+
+extern int seq_printf(struct seq_file *m, const char *fmt, ...) __printf(2, 3);
+extern int seq_puts(struct seq_file *m, const char *s);
+extern int single_open(struct file *file,
+				int (*show)(struct seq_file *m, void *v), void *data);
+extern int single_release(struct inode *inode, struct file *file);
+extern ssize_t seq_read(struct file *file, char __user *buf, size_t size, loff_t *ppos);
+extern loff_t seq_lseek(struct file *file, loff_t offset, int whence);
+
+extern struct dentry *debugfs_create_dir(const char *name, struct dentry *parent);
+extern struct dentry *debugfs_create_file(const char *name, umode_t mode,
+				struct dentry *parent, void *data,
+				const struct file_operations *fops);
+extern void debugfs_remove_recursive(struct dentry *dentry);
+
+/*
+ * host harness control (siw_host_kernel.c)
+ */
+extern int siw_host_log_level;
+extern FILE *siw_host_evt_log;
+
+extern int siw_host_run_works(u64 span_ns);
+extern int siw_host_pending_works(void);
+
+extern int siw_host_irq_fire(unsigned int irq);
+
+extern ssize_t siw_host_sysfs_show(struct kobject *kobj, const char *name,
+				char *buf);
+extern ssize_t siw_host_sysfs_store(struct kobject *kobj, const char *name,
+				const char *buf, size_t count);
+extern ssize_t siw_host_sysfs_write_bin(struct kobject *kobj, const char *name,
+				char *buf, loff_t off, size_t count);
+extern ssize_t siw_host_debugfs_read(const char *name, char *buf, size_t size);
+
+#endif	/* __SIW_HOST_H */
@@ -0,0 +1,154 @@
+/*
+ * siw_host_input.h - SiW touch host build shims, input core
+ *
+ * Copyright (C) 2016 Silicon Works - http://www.siliconworks.co.kr
+ * Author: Hyunho Kim <kimhh@siliconworks.co.kr>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#ifndef __SIW_HOST_INPUT_H
+#define __SIW_HOST_INPUT_H
+
+/*
+ * Only what siw_touch_event.c uses.
+ * Every reported event goes to siw_host_input_event(),
+ * which keeps a text log of the event stream for the replay check.
+ */
+
+#define EV_SYN				0x00
+#define EV_KEY				0x01
+#define EV_REL				0x02
+#define EV_ABS				0x03
+#define EV_MSC				0x04
+#define EV_SW				0x05
+#define EV_MAX				0x1f
+#define EV_CNT				(EV_MAX + 1)
+
+#define SYN_REPORT			0
+#define SYN_MT_REPORT		2
+
+#define ABS_X				0x00
+#define ABS_Y				0x01
+#define ABS_PRESSURE		0x18
+#define ABS_MISC			0x28
+
+#define ABS_MT_SLOT			0x2f
+#define ABS_MT_TOUCH_MAJOR	0x30
+#define ABS_MT_TOUCH_MINOR	0x31
+#define ABS_MT_WIDTH_MAJOR	0x32
+#define ABS_MT_WIDTH_MINOR	0x33
+#define ABS_MT_ORIENTATION	0x34
+#define ABS_MT_POSITION_X	0x35
+#define ABS_MT_POSITION_Y	0x36
+#define ABS_MT_TOOL_TYPE	0x37
+#define ABS_MT_BLOB_ID		0x38
+#define ABS_MT_TRACKING_ID	0x39
+#define ABS_MT_PRESSURE		0x3a
+#define ABS_MAX				0x3f
+#define ABS_CNT				(ABS_MAX + 1)
+
+#define KEY_MAX				0x2ff
+#define KEY_CNT				(KEY_MAX + 1)
+#define KEY_POWER			116
+#define KEY_WAKEUP			143
+#define BTN_TOUCH			0x14a
+#define BTN_TOOL_FINGER		0x145
+
+#define INPUT_PROP_POINTER	0x00
+#define INPUT_PROP_DIRECT	0x01
+#define INPUT_PROP_MAX		0x1f
+#define INPUT_PROP_CNT		(INPUT_PROP_MAX + 1)
+
+#define MT_TOOL_FINGER		0
+#define INPUT_MT_DIRECT		0x0002
+
+#define BUS_I2C				0x18
+#define BUS_SPI				0x1C
+
+struct input_id {
+	__u16 bustype;
+	__u16 vendor;
+	__u16 product;
+	__u16 version;
+};
+
+struct input_absinfo {
+	__s32 value;
+	__s32 minimum;
+	__s32 maximum;
+	__s32 fuzz;
+	__s32 flat;
+	__s32 resolution;
+};
+
+struct input_dev {
+	const char *name;
+	const char *phys;
+	const char *uniq;
+	struct input_id id;
+
+	unsigned long propbit[BITS_TO_LONGS(INPUT_PROP_CNT)];
+	unsigned long evbit[BITS_TO_LONGS(EV_CNT)];
+	unsigned long keybit[BITS_TO_LONGS(KEY_CNT)];
+	unsigned long absbit[BITS_TO_LONGS(ABS_CNT)];
+
+	struct input_absinfo absinfo[ABS_CNT];
+	int num_slots;
+	int slot;
+
+	struct device dev;
+	int registered;
+};
+
+extern struct input_dev *input_allocate_device(void);
+extern void input_free_device(struct input_dev *dev);
+extern int input_register_device(struct input_dev *dev);
+extern void input_unregister_device(struct input_dev *dev);
+extern void input_set_abs_params(struct input_dev *dev, unsigned int axis,
+				int min, int max, int fuzz, int flat);
+extern void input_set_capability(struct input_dev *dev, unsigned int type,
+				unsigned int code);
+extern int input_mt_init_slots(struct input_dev *dev, unsigned int num_slots,
+				unsigned int flags);
+extern void input_mt_destroy_slots(struct input_dev *dev);
+extern void siw_host_input_event(struct input_dev *dev,
+				unsigned int type, unsigned int code, int value);
+
+#define input_event				siw_host_input_event
+
+static inline void input_set_drvdata(struct input_dev *dev, void *data)
+{
+	dev_set_drvdata(&dev->dev, data);
+}
+
+static inline void *input_get_drvdata(struct input_dev *dev)
+{
+	return dev_get_drvdata(&dev->dev);
+}
+
+static inline void input_report_abs(struct input_dev *dev,
+				unsigned int code, int value)
+{
+	input_event(dev, EV_ABS, code, value);
+}
+
+static inline void input_report_key(struct input_dev *dev,
+				unsigned int code, int value)
+{
+	input_event(dev, EV_KEY, code, !!value);
+}
+
+static inline void input_sync(struct input_dev *dev)
+{
+	input_event(dev, EV_SYN, SYN_REPORT, 0);
+}
+
+static inline void input_mt_slot(struct input_dev *dev, int slot)
+{
+	input_event(dev, EV_ABS, ABS_MT_SLOT, slot);
+}
+
+#endif	/* __SIW_HOST_INPUT_H */
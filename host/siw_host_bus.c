@@ -0,0 +1,281 @@
+/*
+ * siw_host_bus.c - SiW touch host build, bus and chip model
+ *
+ * Copyright (C) 2016 Silicon Works - http://www.siliconworks.co.kr
+ * Author: Hyunho Kim <kimhh@siliconworks.co.kr>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#include <siw_host.h>
+
+#include "siw_touch.h"
+#include "siw_touch_hal.h"
+#include "siw_touch_bus.h"
+
+#include "siw_host_main.h"
+
+/*
+ * Stands in for siw_touch_bus_i2c.c :
+ * the i2c driver registration probes one client at once,
+ * as siw_touch_i2c_probe does, on a register file modeling the IC.
+ *
+ * Word address space as seen by the hal (see __siw_hal_do_reg_read_buf),
+ * no sram window : the probe and init sequence only.
+ */
+
+enum {
+	SIW_HOST_REG_NUM	= (1<<12),
+	SIW_HOST_I2C_ADDR	= 0x28,
+};
+
+static u32 siw_host_reg[SIW_HOST_REG_NUM];
+
+static struct device siw_host_i2c_adap = {
+	.name = "i2c-host",
+};
+
+static struct i2c_client siw_host_i2c_client = {
+	.addr = SIW_HOST_I2C_ADDR,
+	.dev = {
+		.parent = &siw_host_i2c_adap,
+		.name = "0-0028",
+	},
+	.irq = SIW_HOST_IRQ,
+};
+
+void siw_host_chip_set(u32 addr, u32 value)
+{
+	if (addr < SIW_HOST_REG_NUM)
+		siw_host_reg[addr] = value;
+}
+
+u32 siw_host_chip_get(u32 addr)
+{
+	return (addr < SIW_HOST_REG_NUM) ? siw_host_reg[addr] : 0;
+}
+
+/*
+ * Power-on state of the IC : LG4894, f/w v1.05, boot done,
+ * device status normal (see siw_hal_do_check_status)
+ */
+void siw_host_chip_init(struct siw_hal_reg *reg)
+{
+	memset(siw_host_reg, 0, sizeof(siw_host_reg));
+
+	siw_host_chip_set(reg->spr_chip_id, ('4'<<24) | ('8'<<16) | ('9'<<8) | '4');
+	siw_host_chip_set(reg->tc_version, 0x04040105);
+	siw_host_chip_set(reg->info_chip_version, 0x01);
+	siw_host_chip_set(reg->tc_product_id1, 0x3357304C);		/* "L0W53LG4" */
+	siw_host_chip_set(reg->tc_product_id1 + 1, 0x3447474C);
+	siw_host_chip_set(reg->spr_boot_status, (1<<2));
+	siw_host_chip_set(reg->tc_status, 0x06D580E7);
+}
+
+static inline u32 siw_host_hdr_addr(u8 *hdr)
+{
+	return ((hdr[0] & 0x0F)<<8) | hdr[1];
+}
+
+static void siw_host_chip_read(u32 addr, u8 *buf, int size)
+{
+	int offs = addr<<2;
+	int len = 0;
+
+	if (offs < sizeof(siw_host_reg))
+		len = min_t(int, size, sizeof(siw_host_reg) - offs);
+
+	memcpy(buf, (u8 *)siw_host_reg + offs, len);
+	memset(buf + len, 0, size - len);
+}
+
+static void siw_host_chip_write(u32 addr, u8 *buf, int size)
+{
+	int offs = addr<<2;
+	int len = 0;
+
+	if (offs < sizeof(siw_host_reg))
+		len = min_t(int, size, sizeof(siw_host_reg) - offs);
+
+	memcpy((u8 *)siw_host_reg + offs, buf, len);
+}
+
+/* the hal ops are in place here, see siw_touch_probe_normal */
+static int siw_host_i2c_init(struct device *dev)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+
+	siw_host_chip_init(siw_ops_reg(ts));
+
+	return 0;
+}
+
+static int siw_host_i2c_read(struct device *dev, void *msg_data)
+{
+	struct touch_bus_msg *msg = msg_data;
+
+	if ((msg->tx_size < 2) || (msg->rx_size < 0))
+		return -EINVAL;
+
+	/* i2c : no rx header */
+	siw_host_chip_read(siw_host_hdr_addr(msg->tx_buf),
+			msg->rx_buf, msg->rx_size);
+
+	return 0;
+}
+
+static int siw_host_i2c_write(struct device *dev, void *msg_data)
+{
+	struct touch_bus_msg *msg = msg_data;
+
+	if (msg->tx_size < I2C_BUS_TX_HDR_SZ)
+		return -EINVAL;
+
+	siw_host_chip_write(siw_host_hdr_addr(msg->tx_buf),
+			&msg->tx_buf[I2C_BUS_TX_HDR_SZ],
+			msg->tx_size - I2C_BUS_TX_HDR_SZ);
+
+	return 0;
+}
+
+static int siw_host_i2c_xfer(struct device *dev, void *xfer)
+{
+	t_dev_info(dev, "I2C xfer : not supported\n");
+	return -EINVAL;
+}
+
+static struct siw_ts *siw_host_i2c_alloc(struct i2c_client *i2c,
+				struct siw_touch_bus_drv *bus_drv)
+{
+	struct device *dev = &i2c->dev;
+	struct siw_ts *ts = NULL;
+	int ret;
+
+	ts = touch_kzalloc(dev, sizeof(*ts), GFP_KERNEL);
+	if (ts == NULL)
+		return NULL;
+
+	ts->bus_dev = i2c;
+	ts->addr = (size_t)i2c->addr;
+	ts->dev = dev;
+	ts->irq = i2c->irq;
+
+	ret = siw_setup_params(ts, bus_drv->pdata);
+	if (ret < 0)
+		goto out;
+
+	ts->pdata = bus_drv->pdata;
+
+	siw_setup_operations(ts, bus_drv->pdata->ops);
+
+	ts->bus_init = siw_host_i2c_init;
+	ts->bus_read = siw_host_i2c_read;
+	ts->bus_write = siw_host_i2c_write;
+	ts->bus_xfer = siw_host_i2c_xfer;
+
+	ret = siw_touch_bus_tr_data_init(ts);
+	if (ret < 0)
+		goto out;
+
+	dev_set_drvdata(dev, ts);
+
+	return ts;
+
+out:
+	touch_kfree(dev, ts);
+	return NULL;
+}
+
+int siw_touch_i2c_add_driver(void *data)
+{
+	struct siw_touch_chip_data *chip_data = data;
+	struct siw_touch_bus_drv *bus_drv = NULL;
+	struct siw_touch_pdata *pdata = NULL;
+	struct siw_ts *ts = NULL;
+	int bus_type;
+	int ret = 0;
+
+	bus_type = pdata_bus_type((struct siw_touch_pdata *)chip_data->pdata);
+
+	bus_drv = siw_touch_bus_create_bus_drv(bus_type);
+	if (!bus_drv)
+		return -ENOMEM;
+
+	pdata = siw_touch_bus_create_bus_pdata(bus_type);
+	if (!pdata) {
+		ret = -ENOMEM;
+		goto out_pdata;
+	}
+
+	memcpy(pdata, chip_data->pdata, sizeof(*pdata));
+	bus_drv->pdata = pdata;
+
+	ts = siw_host_i2c_alloc(&siw_host_i2c_client, bus_drv);
+	if (!ts) {
+		ret = -ENOMEM;
+		goto out_alloc;
+	}
+
+	ret = siw_touch_probe(ts);
+	if (ret)
+		goto out_probe;
+
+	chip_data->bus_drv = bus_drv;
+
+	return 0;
+
+out_probe:
+	dev_set_drvdata(&siw_host_i2c_client.dev, NULL);
+	siw_touch_bus_tr_data_free(ts);
+	touch_kfree(ts->dev, ts);
+
+out_alloc:
+	siw_touch_bus_free_bus_pdata(pdata);
+
+out_pdata:
+	siw_touch_bus_free_bus_drv(bus_drv);
+
+	return ret;
+}
+
+int siw_touch_i2c_del_driver(void *data)
+{
+	struct siw_touch_chip_data *chip_data = data;
+	struct siw_touch_bus_drv *bus_drv = chip_data->bus_drv;
+	struct siw_ts *ts = to_touch_core(&siw_host_i2c_client.dev);
+
+	if (!bus_drv)
+		return 0;
+
+	if (ts) {
+		siw_touch_remove(ts);
+
+		dev_set_drvdata(&siw_host_i2c_client.dev, NULL);
+		siw_touch_bus_tr_data_free(ts);
+		touch_kfree(ts->dev, ts);
+	}
+
+	siw_touch_bus_free_bus_pdata(bus_drv->pdata);
+	siw_touch_bus_free_bus_drv(bus_drv);
+	chip_data->bus_drv = NULL;
+
+	return 0;
+}
+
+int siw_touch_spi_add_driver(void *data)
+{
+	t_pr_err("SPI : not supported in host build\n");
+	return -ENODEV;
+}
+
+int siw_touch_spi_del_driver(void *data)
+{
+	return -ENODEV;
+}
+
+struct siw_ts *siw_host_bus_ts(void)
+{
+	return to_touch_core(&siw_host_i2c_client.dev);
+}
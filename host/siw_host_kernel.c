@@ -0,0 +1,1138 @@
+/*
+ * siw_host_kernel.c - SiW touch host build, kernel runtime shims
+ *
+ * Copyright (C) 2016 Silicon Works - http://www.siliconworks.co.kr
+ * Author: Hyunho Kim <kimhh@siliconworks.co.kr>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#include <time.h>
+
+/* before siw_host.h, which renames struct timespec */
+static unsigned long long siw_host_mono_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#include <siw_host.h>
+
+/*
+ * print
+ */
+int siw_host_log_level = 3;		/* KERN_ERR */
+FILE *siw_host_evt_log;
+
+static int siw_host_log_lvl(const char **fmt)
+{
+	const char *s = *fmt;
+
+	if ((s[0] == '<') && (s[1] >= '0') && (s[1] <= '7') && (s[2] == '>')) {
+		*fmt = s + 3;
+		return s[1] - '0';
+	}
+	return 4;	/* default loglevel */
+}
+
+static void siw_host_vlog(const char *fmt, const char *prefix, va_list args)
+{
+	int lvl = siw_host_log_lvl(&fmt);
+
+	if (lvl > siw_host_log_level)
+		return;
+
+	if (prefix)
+		fprintf(stderr, "%s: ", prefix);
+	vfprintf(stderr, fmt, args);
+}
+
+int siw_host_printk(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	siw_host_vlog(fmt, NULL, args);
+	va_end(args);
+
+	return 0;
+}
+
+void siw_host_dev_printk(const char *level, const struct device *dev,
+				const char *fmt, ...)
+{
+	va_list args;
+	int lvl = siw_host_log_lvl(&level);
+
+	if (lvl > siw_host_log_level)
+		return;
+
+	va_start(args, fmt);
+	fprintf(stderr, "%s: ", dev_name(dev));
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+}
+
+void siw_host_bug(const char *file, int line)
+{
+	fprintf(stderr, "BUG at %s:%d\n", file, line);
+	abort();
+}
+
+void siw_host_warn(const char *file, int line)
+{
+	fprintf(stderr, "WARNING at %s:%d\n", file, line);
+}
+
+/*
+ * crc32 (little endian, poly 0xEDB88320)
+ */
+u32 crc32_le(u32 crc, const unsigned char *p, size_t len)
+{
+	int i;
+
+	while (len--) {
+		crc ^= *p++;
+		for (i = 0; i < 8; i++)
+			crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+	}
+	return crc;
+}
+
+/*
+ * virtual clock
+ * Real monotonic time plus the total time spent in sleeps,
+ * sleeps themselves return at once.
+ */
+static u64 siw_host_clk_base;
+static u64 siw_host_clk_offs;
+
+u64 siw_host_clock_ns(void)
+{
+	u64 now = siw_host_mono_ns();
+
+	if (!siw_host_clk_base)
+		siw_host_clk_base = now;
+
+	return now - siw_host_clk_base + siw_host_clk_offs;
+}
+
+void siw_host_sleep_ns(u64 ns)
+{
+	siw_host_clk_offs += ns;
+}
+
+unsigned long get_seconds(void)
+{
+	return (unsigned long)(siw_host_clock_ns() / NSEC_PER_SEC);
+}
+
+/*
+ * mutex : no concurrency, so a lock already held is a deadlock
+ */
+void siw_host_mutex_init(struct mutex *lock, const char *name)
+{
+	lock->locked = 0;
+	lock->init = 1;
+	lock->name = name;
+}
+
+void siw_host_mutex_lock(struct mutex *lock, const char *file, int line)
+{
+	if (lock->locked) {
+		fprintf(stderr, "deadlock: %s at %s:%d\n",
+			(lock->name) ? lock->name : "mutex", file, line);
+		abort();
+	}
+	lock->locked = 1;
+}
+
+int siw_host_mutex_trylock(struct mutex *lock)
+{
+	if (lock->locked)
+		return 0;
+	lock->locked = 1;
+	return 1;
+}
+
+void siw_host_mutex_unlock(struct mutex *lock, const char *file, int line)
+{
+	if (!lock->locked) {
+		fprintf(stderr, "unlock of free mutex: %s at %s:%d\n",
+			(lock->name) ? lock->name : "mutex", file, line);
+		abort();
+	}
+	lock->locked = 0;
+}
+
+/*
+ * kthread : never started
+ */
+static struct task_struct siw_host_task = {
+	.pid = 1,
+	.comm = "siw_host",
+};
+struct task_struct *siw_host_current = &siw_host_task;
+
+struct task_struct *siw_host_kthread_create(int (*fn)(void *data),
+				void *data, const char *name)
+{
+	struct task_struct *k = kzalloc(sizeof(*k), GFP_KERNEL);
+
+	if (!k)
+		return ERR_PTR(-ENOMEM);
+
+	k->fn = fn;
+	k->data = data;
+	strlcpy(k->comm, name, sizeof(k->comm));
+
+	return k;
+}
+
+int kthread_stop(struct task_struct *k)
+{
+	kfree(k);
+	return 0;
+}
+
+bool kthread_should_stop(void)
+{
+	return true;
+}
+
+/*
+ * workqueue
+ * One global list ordered by due time, run by siw_host_run_works()
+ */
+static LIST_HEAD(siw_host_works);
+static struct work_struct *siw_host_work_running;
+
+struct workqueue_struct *siw_host_alloc_wq(const char *name)
+{
+	struct workqueue_struct *wq = kzalloc(sizeof(*wq), GFP_KERNEL);
+
+	if (wq)
+		strlcpy(wq->name, name, sizeof(wq->name));
+	return wq;
+}
+
+static bool siw_host_del_work(struct work_struct *work)
+{
+	if (!work->pending)
+		return false;
+
+	list_del_init(&work->entry);
+	work->pending = 0;
+	return true;
+}
+
+static void siw_host_add_work(struct work_struct *work, u64 due_ns)
+{
+	struct work_struct *pos;
+
+	work->due_ns = due_ns;
+	work->pending = 1;
+
+	list_for_each_entry(pos, &siw_host_works, entry) {
+		if (pos->due_ns > due_ns) {
+			__list_add(&work->entry, pos->entry.prev, &pos->entry);
+			return;
+		}
+	}
+	list_add_tail(&work->entry, &siw_host_works);
+}
+
+void destroy_workqueue(struct workqueue_struct *wq)
+{
+	kfree(wq);
+}
+
+bool queue_work(struct workqueue_struct *wq, struct work_struct *work)
+{
+	if (work->pending)
+		return false;
+
+	siw_host_add_work(work, siw_host_clock_ns());
+	return true;
+}
+
+bool queue_delayed_work(struct workqueue_struct *wq,
+				struct delayed_work *dwork, unsigned long delay)
+{
+	struct work_struct *work = &dwork->work;
+
+	if (work->pending)
+		return false;
+
+	siw_host_add_work(work, siw_host_clock_ns() +
+			(u64)jiffies_to_usecs(delay) * NSEC_PER_USEC);
+	return true;
+}
+
+bool mod_delayed_work(struct workqueue_struct *wq,
+				struct delayed_work *dwork, unsigned long delay)
+{
+	bool pending = siw_host_del_work(&dwork->work);
+
+	queue_delayed_work(wq, dwork, delay);
+	return pending;
+}
+
+bool cancel_work_sync(struct work_struct *work)
+{
+	return siw_host_del_work(work);
+}
+
+bool cancel_delayed_work(struct delayed_work *dwork)
+{
+	return siw_host_del_work(&dwork->work);
+}
+
+bool cancel_delayed_work_sync(struct delayed_work *dwork)
+{
+	return siw_host_del_work(&dwork->work);
+}
+
+static void siw_host_do_work(struct work_struct *work)
+{
+	siw_host_del_work(work);
+
+	siw_host_work_running = work;
+	work->func(work);
+	siw_host_work_running = NULL;
+}
+
+bool flush_work(struct work_struct *work)
+{
+	if (!work->pending || (siw_host_work_running == work))
+		return false;
+
+	siw_host_do_work(work);
+	return true;
+}
+
+bool flush_delayed_work(struct delayed_work *dwork)
+{
+	return flush_work(&dwork->work);
+}
+
+void flush_workqueue(struct workqueue_struct *wq)
+{
+	/* works are not tracked per queue */
+}
+
+/*
+ * Runs the queued works in due order for span_ns of virtual time,
+ * the clock jumps forward to the next due work.
+ * Returns the number of works run.
+ */
+int siw_host_run_works(u64 span_ns)
+{
+	u64 end = siw_host_clock_ns() + span_ns;
+	struct work_struct *work;
+	u64 now;
+	int cnt = 0;
+
+	while (!list_empty(&siw_host_works)) {
+		work = list_first_entry(&siw_host_works, struct work_struct, entry);
+		if (work->due_ns > end)
+			break;
+
+		now = siw_host_clock_ns();
+		if (work->due_ns > now)
+			siw_host_sleep_ns(work->due_ns - now);
+
+		siw_host_do_work(work);
+		cnt++;
+	}
+
+	return cnt;
+}
+
+int siw_host_pending_works(void)
+{
+	struct work_struct *work;
+	int cnt = 0;
+
+	list_for_each_entry(work, &siw_host_works, entry)
+		cnt++;
+
+	return cnt;
+}
+
+async_cookie_t async_schedule(async_func_t func, void *data)
+{
+	func(data, 0);
+	return 0;
+}
+
+/*
+ * irq
+ */
+#define SIW_HOST_IRQ_MAX	4
+
+struct siw_host_irq {
+	unsigned int irq;
+	irq_handler_t handler;
+	irq_handler_t thread_fn;
+	void *dev_id;
+	int depth;
+};
+
+static struct siw_host_irq siw_host_irqs[SIW_HOST_IRQ_MAX];
+
+static struct siw_host_irq *siw_host_find_irq(unsigned int irq)
+{
+	int i;
+
+	for (i = 0; i < SIW_HOST_IRQ_MAX; i++) {
+		if (siw_host_irqs[i].handler && (siw_host_irqs[i].irq == irq))
+			return &siw_host_irqs[i];
+	}
+	return NULL;
+}
+
+int request_threaded_irq(unsigned int irq, irq_handler_t handler,
+				irq_handler_t thread_fn, unsigned long flags,
+				const char *name, void *dev)
+{
+	int i;
+
+	if (siw_host_find_irq(irq))
+		return -EBUSY;
+
+	for (i = 0; i < SIW_HOST_IRQ_MAX; i++) {
+		if (!siw_host_irqs[i].handler) {
+			siw_host_irqs[i].irq = irq;
+			siw_host_irqs[i].handler = handler;
+			siw_host_irqs[i].thread_fn = thread_fn;
+			siw_host_irqs[i].dev_id = dev;
+			siw_host_irqs[i].depth = 0;
+			return 0;
+		}
+	}
+	return -ENOSPC;
+}
+
+void free_irq(unsigned int irq, void *dev_id)
+{
+	struct siw_host_irq *d = siw_host_find_irq(irq);
+
+	if (d)
+		memset(d, 0, sizeof(*d));
+}
+
+void enable_irq(unsigned int irq)
+{
+	struct siw_host_irq *d = siw_host_find_irq(irq);
+
+	if (d && d->depth)
+		d->depth--;
+}
+
+void disable_irq(unsigned int irq)
+{
+	struct siw_host_irq *d = siw_host_find_irq(irq);
+
+	if (d)
+		d->depth++;
+}
+
+void disable_irq_nosync(unsigned int irq)
+{
+	disable_irq(irq);
+}
+
+/*
+ * Raises the line : hard handler, then the thread when woken
+ */
+int siw_host_irq_fire(unsigned int irq)
+{
+	struct siw_host_irq *d = siw_host_find_irq(irq);
+	irqreturn_t ret;
+
+	if (!d)
+		return -ENODEV;
+	if (d->depth)
+		return -EBUSY;
+
+	ret = d->handler(irq, d->dev_id);
+	if ((ret == IRQ_WAKE_THREAD) && d->thread_fn)
+		ret = d->thread_fn(irq, d->dev_id);
+
+	return ret;
+}
+
+/*
+ * sysfs
+ */
+struct siw_host_sysfs_node {
+	struct list_head entry;
+	struct kobject *kobj;
+	const struct attribute_group *grp;
+	const struct bin_attribute *bin;
+};
+
+static LIST_HEAD(siw_host_sysfs_nodes);
+
+int kobject_init_and_add(struct kobject *kobj, struct kobj_type *ktype,
+				struct kobject *parent, const char *fmt, ...)
+{
+	char name[64];
+	va_list args;
+
+	va_start(args, fmt);
+	vsnprintf(name, sizeof(name), fmt, args);
+	va_end(args);
+
+	kobj->name = strdup(name);
+	kobj->parent = parent;
+	kobj->ktype = ktype;
+	kobj->state_initialized = 1;
+
+	return 0;
+}
+
+void kobject_del(struct kobject *kobj)
+{
+	free((void *)kobj->name);
+	kobj->name = NULL;
+	kobj->state_initialized = 0;
+}
+
+void kobject_put(struct kobject *kobj)
+{
+	if (kobj->ktype && kobj->ktype->release)
+		kobj->ktype->release(kobj);
+}
+
+int kobject_uevent_env(struct kobject *kobj, enum kobject_action action,
+				char *envp[])
+{
+	return 0;
+}
+
+int kobject_uevent(struct kobject *kobj, enum kobject_action action)
+{
+	return 0;
+}
+
+static int siw_host_sysfs_add(struct kobject *kobj,
+				const struct attribute_group *grp,
+				const struct bin_attribute *bin)
+{
+	struct siw_host_sysfs_node *node = kzalloc(sizeof(*node), GFP_KERNEL);
+
+	if (!node)
+		return -ENOMEM;
+
+	node->kobj = kobj;
+	node->grp = grp;
+	node->bin = bin;
+	list_add_tail(&node->entry, &siw_host_sysfs_nodes);
+
+	return 0;
+}
+
+static void siw_host_sysfs_del(struct kobject *kobj,
+				const struct attribute_group *grp,
+				const struct bin_attribute *bin)
+{
+	struct siw_host_sysfs_node *node, *n;
+
+	list_for_each_entry_safe(node, n, &siw_host_sysfs_nodes, entry) {
+		if ((node->kobj == kobj) && (node->grp == grp) && (node->bin == bin)) {
+			list_del(&node->entry);
+			kfree(node);
+			return;
+		}
+	}
+}
+
+int sysfs_create_group(struct kobject *kobj, const struct attribute_group *grp)
+{
+	return siw_host_sysfs_add(kobj, grp, NULL);
+}
+
+void sysfs_remove_group(struct kobject *kobj, const struct attribute_group *grp)
+{
+	siw_host_sysfs_del(kobj, grp, NULL);
+}
+
+int sysfs_create_bin_file(struct kobject *kobj, const struct bin_attribute *attr)
+{
+	return siw_host_sysfs_add(kobj, NULL, attr);
+}
+
+void sysfs_remove_bin_file(struct kobject *kobj, const struct bin_attribute *attr)
+{
+	siw_host_sysfs_del(kobj, NULL, attr);
+}
+
+int sysfs_create_link(struct kobject *kobj, struct kobject *target, const char *name)
+{
+	return 0;
+}
+
+void sysfs_remove_link(struct kobject *kobj, const char *name)
+{
+
+}
+
+static struct attribute *siw_host_sysfs_find(struct kobject *kobj,
+				const char *name)
+{
+	struct siw_host_sysfs_node *node;
+	struct attribute **attr;
+
+	list_for_each_entry(node, &siw_host_sysfs_nodes, entry) {
+		if ((node->kobj != kobj) || !node->grp)
+			continue;
+
+		for (attr = node->grp->attrs; *attr; attr++) {
+			if (!strcmp((*attr)->name, name))
+				return *attr;
+		}
+	}
+	return NULL;
+}
+
+ssize_t siw_host_sysfs_show(struct kobject *kobj, const char *name, char *buf)
+{
+	struct attribute *attr = siw_host_sysfs_find(kobj, name);
+
+	if (!attr || !kobj->ktype->sysfs_ops->show)
+		return -ENOENT;
+
+	memset(buf, 0, PAGE_SIZE);
+	return kobj->ktype->sysfs_ops->show(kobj, attr, buf);
+}
+
+ssize_t siw_host_sysfs_store(struct kobject *kobj, const char *name,
+				const char *buf, size_t count)
+{
+	struct attribute *attr = siw_host_sysfs_find(kobj, name);
+
+	if (!attr || !kobj->ktype->sysfs_ops->store)
+		return -ENOENT;
+
+	return kobj->ktype->sysfs_ops->store(kobj, attr, buf, count);
+}
+
+ssize_t siw_host_sysfs_write_bin(struct kobject *kobj, const char *name,
+				char *buf, loff_t off, size_t count)
+{
+	struct siw_host_sysfs_node *node;
+	struct bin_attribute *bin;
+
+	list_for_each_entry(node, &siw_host_sysfs_nodes, entry) {
+		bin = (struct bin_attribute *)node->bin;
+		if ((node->kobj != kobj) || !bin || strcmp(bin->attr.name, name))
+			continue;
+
+		if (!bin->write)
+			return -EPERM;
+
+		return bin->write(NULL, kobj, bin, buf, off, count);
+	}
+	return -ENOENT;
+}
+
+/*
+ * debugfs, seq_file
+ */
+#define SIW_HOST_SEQ_SIZE	(64<<10)
+
+struct siw_host_debugfs {
+	struct list_head entry;
+	struct dentry dentry;
+	struct inode inode;
+	struct dentry *parent;
+	const struct file_operations *fops;
+	char name[64];
+};
+
+static LIST_HEAD(siw_host_debugfs_nodes);
+
+static struct dentry *siw_host_debugfs_add(const char *name,
+				struct dentry *parent, void *data,
+				const struct file_operations *fops)
+{
+	struct siw_host_debugfs *node = kzalloc(sizeof(*node), GFP_KERNEL);
+
+	if (!node)
+		return NULL;
+
+	strlcpy(node->name, name, sizeof(node->name));
+	node->parent = parent;
+	node->fops = fops;
+	node->inode.i_private = data;
+	node->dentry.d_inode = &node->inode;
+	list_add_tail(&node->entry, &siw_host_debugfs_nodes);
+
+	return &node->dentry;
+}
+
+struct dentry *debugfs_create_dir(const char *name, struct dentry *parent)
+{
+	return siw_host_debugfs_add(name, parent, NULL, NULL);
+}
+
+struct dentry *debugfs_create_file(const char *name, umode_t mode,
+				struct dentry *parent, void *data,
+				const struct file_operations *fops)
+{
+	return siw_host_debugfs_add(name, parent, data, fops);
+}
+
+void debugfs_remove_recursive(struct dentry *dentry)
+{
+	struct siw_host_debugfs *node, *n;
+
+	list_for_each_entry_safe(node, n, &siw_host_debugfs_nodes, entry) {
+		if ((&node->dentry == dentry) || (node->parent == dentry)) {
+			list_del(&node->entry);
+			kfree(node);
+		}
+	}
+}
+
+/*
+ * Reads a debugfs file (by file name) through its fops
+ */
+ssize_t siw_host_debugfs_read(const char *name, char *buf, size_t size)
+{
+	struct siw_host_debugfs *node;
+	struct file file;
+	loff_t pos = 0;
+	ssize_t ret;
+
+	list_for_each_entry(node, &siw_host_debugfs_nodes, entry) {
+		if (!node->fops || strcmp(node->name, name))
+			continue;
+
+		memset(&file, 0, sizeof(file));
+		file.f_inode = &node->inode;
+		file.f_op = node->fops;
+
+		ret = node->fops->open(&node->inode, &file);
+		if (ret < 0)
+			return ret;
+
+		ret = node->fops->read(&file, buf, size - 1, &pos);
+		buf[(ret > 0) ? ret : 0] = 0;
+
+		node->fops->release(&node->inode, &file);
+
+		return ret;
+	}
+	return -ENOENT;
+}
+
+int seq_printf(struct seq_file *m, const char *fmt, ...)
+{
+	va_list args;
+	int len;
+
+	if (m->count >= m->size)
+		return -1;
+
+	va_start(args, fmt);
+	len = vsnprintf(m->buf + m->count, m->size - m->count, fmt, args);
+	va_end(args);
+
+	m->count = min_t(size_t, m->count + len, m->size);
+
+	return 0;
+}
+
+int seq_puts(struct seq_file *m, const char *s)
+{
+	return seq_printf(m, "%s", s);
+}
+
+int single_open(struct file *file,
+				int (*show)(struct seq_file *m, void *v), void *data)
+{
+	struct seq_file *m = kzalloc(sizeof(*m), GFP_KERNEL);
+
+	if (!m)
+		return -ENOMEM;
+
+	m->show = show;
+	m->private = data;
+	file->private_data = m;
+
+	return 0;
+}
+
+int single_release(struct inode *inode, struct file *file)
+{
+	struct seq_file *m = file->private_data;
+
+	if (m) {
+		kfree(m->buf);
+		kfree(m);
+	}
+	file->private_data = NULL;
+
+	return 0;
+}
+
+ssize_t seq_read(struct file *file, char __user *buf, size_t size, loff_t *ppos)
+{
+	struct seq_file *m = file->private_data;
+	size_t len;
+	int ret;
+
+	if (!m->buf) {
+		m->buf = kzalloc(SIW_HOST_SEQ_SIZE, GFP_KERNEL);
+		if (!m->buf)
+			return -ENOMEM;
+		m->size = SIW_HOST_SEQ_SIZE;
+
+		ret = m->show(m, NULL);
+		if (ret < 0)
+			return ret;
+	}
+
+	if (*ppos >= m->count)
+		return 0;
+
+	len = min_t(size_t, size, m->count - *ppos);
+	memcpy(buf, m->buf + *ppos, len);
+	*ppos += len;
+
+	return len;
+}
+
+loff_t seq_lseek(struct file *file, loff_t offset, int whence)
+{
+	return offset;
+}
+
+/*
+ * device, bus
+ */
+int bus_register(struct bus_type *bus)
+{
+	return 0;
+}
+
+void bus_unregister(struct bus_type *bus)
+{
+
+}
+
+int subsys_system_register(struct bus_type *subsys,
+				const struct attribute_group **groups)
+{
+	return 0;
+}
+
+int device_register(struct device *dev)
+{
+	if (dev->init_name)
+		dev_set_name(dev, "%s", dev->init_name);
+	return 0;
+}
+
+void device_unregister(struct device *dev)
+{
+	if (dev->release)
+		dev->release(dev);
+}
+
+void *dma_alloc_coherent(struct device *dev, size_t size,
+				dma_addr_t *dma_handle, gfp_t flag)
+{
+	void *buf = calloc(1, size);
+
+	if (dma_handle)
+		*dma_handle = (dma_addr_t)(uintptr_t)buf;
+	return buf;
+}
+
+void dma_free_coherent(struct device *dev, size_t size,
+				void *cpu_addr, dma_addr_t dma_handle)
+{
+	free(cpu_addr);
+}
+
+/*
+ * gpio : a latch per pin, inputs read high (irq line idle)
+ */
+#define SIW_HOST_GPIO_MAX	256
+
+static int siw_host_gpio_val[SIW_HOST_GPIO_MAX];
+static int siw_host_gpio_req[SIW_HOST_GPIO_MAX];
+
+int gpio_request(unsigned int gpio, const char *label)
+{
+	if (gpio >= SIW_HOST_GPIO_MAX)
+		return -EINVAL;
+	if (siw_host_gpio_req[gpio])
+		return -EBUSY;
+
+	siw_host_gpio_req[gpio] = 1;
+	siw_host_gpio_val[gpio] = 1;
+	return 0;
+}
+
+void gpio_free(unsigned int gpio)
+{
+	if (gpio < SIW_HOST_GPIO_MAX)
+		siw_host_gpio_req[gpio] = 0;
+}
+
+int gpio_direction_input(unsigned int gpio)
+{
+	return (gpio < SIW_HOST_GPIO_MAX) ? 0 : -EINVAL;
+}
+
+int gpio_direction_output(unsigned int gpio, int value)
+{
+	if (gpio >= SIW_HOST_GPIO_MAX)
+		return -EINVAL;
+
+	siw_host_gpio_val[gpio] = !!value;
+	return 0;
+}
+
+int gpio_get_value(unsigned int gpio)
+{
+	return (gpio < SIW_HOST_GPIO_MAX) ? siw_host_gpio_val[gpio] : 0;
+}
+
+void gpio_set_value(unsigned int gpio, int value)
+{
+	if (gpio < SIW_HOST_GPIO_MAX)
+		siw_host_gpio_val[gpio] = !!value;
+}
+
+int gpio_to_irq(unsigned int gpio)
+{
+	return gpio;
+}
+
+/*
+ * pinctrl, regulator : not present
+ */
+struct pinctrl *devm_pinctrl_get(struct device *dev)
+{
+	return ERR_PTR(-ENODEV);
+}
+
+void devm_pinctrl_put(struct pinctrl *p)
+{
+
+}
+
+struct pinctrl_state *pinctrl_lookup_state(struct pinctrl *p, const char *name)
+{
+	return ERR_PTR(-ENODEV);
+}
+
+int pinctrl_select_state(struct pinctrl *p, struct pinctrl_state *s)
+{
+	return -ENODEV;
+}
+
+struct regulator *regulator_get(struct device *dev, const char *id)
+{
+	return ERR_PTR(-ENODEV);
+}
+
+void regulator_put(struct regulator *regulator)
+{
+
+}
+
+int regulator_enable(struct regulator *regulator)
+{
+	return -ENODEV;
+}
+
+int regulator_disable(struct regulator *regulator)
+{
+	return -ENODEV;
+}
+
+int regulator_is_enabled(struct regulator *regulator)
+{
+	return 0;
+}
+
+int regulator_set_voltage(struct regulator *regulator, int min_uV, int max_uV)
+{
+	return -ENODEV;
+}
+
+/*
+ * firmware, file : no file system access
+ */
+int request_firmware(const struct firmware **fw, const char *name,
+				struct device *device)
+{
+	*fw = NULL;
+	return -ENOENT;
+}
+
+void release_firmware(const struct firmware *fw)
+{
+
+}
+
+struct file *filp_open(const char *filename, int flags, umode_t mode)
+{
+	return ERR_PTR(-ENOENT);
+}
+
+int filp_close(struct file *filp, void *id)
+{
+	return 0;
+}
+
+ssize_t kernel_read(struct file *file, loff_t offset, char *addr, unsigned long count)
+{
+	return -EINVAL;
+}
+
+loff_t vfs_llseek(struct file *file, loff_t offset, int whence)
+{
+	return -EINVAL;
+}
+
+/*
+ * notifier
+ */
+int siw_host_notifier_register(struct notifier_block **head,
+				struct notifier_block *nb)
+{
+	while (*head) {
+		if (nb->priority > (*head)->priority)
+			break;
+		head = &((*head)->next);
+	}
+	nb->next = *head;
+	*head = nb;
+
+	return 0;
+}
+
+int siw_host_notifier_unregister(struct notifier_block **head,
+				struct notifier_block *nb)
+{
+	while (*head) {
+		if (*head == nb) {
+			*head = nb->next;
+			return 0;
+		}
+		head = &((*head)->next);
+	}
+	return -ENOENT;
+}
+
+int siw_host_notifier_call(struct notifier_block **head,
+				unsigned long val, void *v)
+{
+	struct notifier_block *nb = *head;
+	int ret = NOTIFY_DONE;
+
+	while (nb) {
+		ret = nb->notifier_call(nb, val, v);
+		if (ret & NOTIFY_STOP_MASK)
+			break;
+		nb = nb->next;
+	}
+
+	return ret;
+}
+
+/*
+ * input : events go to siw_host_evt_log as text
+ */
+struct input_dev *input_allocate_device(void)
+{
+	return kzalloc(sizeof(struct input_dev), GFP_KERNEL);
+}
+
+void input_free_device(struct input_dev *dev)
+{
+	kfree(dev);
+}
+
+int input_register_device(struct input_dev *dev)
+{
+	dev_set_name(&dev->dev, "input0");
+	dev->registered = 1;
+	return 0;
+}
+
+void input_unregister_device(struct input_dev *dev)
+{
+	dev->registered = 0;
+}
+
+void input_set_abs_params(struct input_dev *dev, unsigned int axis,
+				int min, int max, int fuzz, int flat)
+{
+	struct input_absinfo *absinfo = &dev->absinfo[axis];
+
+	absinfo->minimum = min;
+	absinfo->maximum = max;
+	absinfo->fuzz = fuzz;
+	absinfo->flat = flat;
+
+	set_bit(EV_ABS, dev->evbit);
+	set_bit(axis, dev->absbit);
+}
+
+void input_set_capability(struct input_dev *dev, unsigned int type,
+				unsigned int code)
+{
+	set_bit(type, dev->evbit);
+	if (type == EV_KEY)
+		set_bit(code, dev->keybit);
+	else if (type == EV_ABS)
+		set_bit(code, dev->absbit);
+}
+
+int input_mt_init_slots(struct input_dev *dev, unsigned int num_slots,
+				unsigned int flags)
+{
+	dev->num_slots = num_slots;
+	input_set_abs_params(dev, ABS_MT_SLOT, 0, num_slots - 1, 0, 0);
+	input_set_abs_params(dev, ABS_MT_TRACKING_ID, 0, 0xFFFF, 0, 0);
+	return 0;
+}
+
+void input_mt_destroy_slots(struct input_dev *dev)
+{
+	dev->num_slots = 0;
+}
+
+void siw_host_input_event(struct input_dev *dev,
+				unsigned int type, unsigned int code, int value)
+{
+	if (!dev->registered || !siw_host_evt_log)
+		return;
+
+	switch (type) {
+	case EV_SYN:
+		fprintf(siw_host_evt_log, "SYN\n");
+		break;
+	case EV_ABS:
+		if (code == ABS_MT_SLOT)
+			dev->slot = value;
+		fprintf(siw_host_evt_log, "ABS %02x %d\n", code, value);
+		break;
+	default:
+		fprintf(siw_host_evt_log, "EV%u %03x %d\n", type, code, value);
+		break;
+	}
+}
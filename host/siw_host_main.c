@@ -0,0 +1,373 @@
+/*
+ * siw_host_main.c - SiW touch host build, harness
+ *
+ * Copyright (C) 2016 Silicon Works - http://www.siliconworks.co.kr
+ * Author: Hyunho Kim <kimhh@siliconworks.co.kr>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#include <siw_host.h>
+
+#include <unistd.h>
+
+#include "siw_touch.h"
+#include "siw_touch_hal.h"
+#include "siw_touch_bus.h"
+
+#include "siw_host_main.h"
+
+/*
+ * Probes the core and the hal of LG4894 on the host (siw_host_bus.c),
+ * turns on the bus emulation and replays a synthetic 120Hz trace
+ * through the emul_trace / emul_replay nodes, as done on target.
+ *
+ * stdout carries only what is deterministic for a given tree :
+ * replay counters, latency stage counts and the input event stream.
+ * Logs go to stderr (-v {level} for more).
+ */
+
+#define SIW_HOST_TRACE_HZ		120
+#define SIW_HOST_TRACE_STEP		(USEC_PER_SEC / SIW_HOST_TRACE_HZ)
+#define SIW_HOST_TRACE_MAX		64
+
+enum {
+	SIW_HOST_MAX_X			= 720,
+	SIW_HOST_MAX_Y			= 1280,
+	SIW_HOST_MAX_PRESSURE	= 255,
+	SIW_HOST_MAX_WIDTH		= 15,
+	SIW_HOST_MAX_ORI		= 1,
+	SIW_HOST_MAX_ID			= 10,
+	/* */
+	SIW_HOST_HW_RST_DELAY	= 210,
+	SIW_HOST_SW_RST_DELAY	= 90,
+};
+
+/* See touch_lg4894.c */
+static char chip_name[32] = "LG4894";
+static char chip_drv_name[32] = SIW_TOUCH_NAME;
+static char chip_idrv_name[32] = SIW_TOUCH_INPUT;
+
+static const struct siw_touch_pdata chip_pdata = {
+	/* Configuration */
+	.chip_id			= "4894",
+	.chip_name			= chip_name,
+	.drv_name			= chip_drv_name,
+	.idrv_name			= chip_idrv_name,
+	.owner				= THIS_MODULE,
+	.chip_type			= CHIP_LG4894,
+	.mode_allowed		= (LCD_MODE_BIT_U0 | LCD_MODE_BIT_U3 | LCD_MODE_BIT_STOP),
+	.fw_size			= (69<<10),
+	.flags				= 0,
+	.irqflags			= (IRQF_TRIGGER_FALLING | IRQF_ONESHOT),
+	.quirks				= (CHIP_QUIRK_NOT_SUPPORT_ASC |
+							CHIP_QUIRK_NOT_SUPPORT_WATCH |
+							CHIP_QUIRK_NOT_SUPPORT_IME |
+							CHIP_QUIRK_NOT_SUPPORT_FW_BURST),
+	/* */
+	.bus_info			= {
+		.bus_type			= BUS_IF_I2C,
+		.buf_size			= 0,
+		.spi_mode			= -1,
+		.bits_per_word		= -1,
+		.max_freq			= -1,
+		.bus_tx_hdr_size	= I2C_BUS_TX_HDR_SZ,
+		.bus_rx_hdr_size	= I2C_BUS_RX_HDR_SZ,
+		.bus_tx_dummy_size	= I2C_BUS_TX_DUMMY_SZ,
+		.bus_rx_dummy_size	= I2C_BUS_RX_DUMMY_SZ,
+	},
+	.pins				= {
+		.reset_pin		= 1,
+		.reset_pin_pol	= OF_GPIO_ACTIVE_LOW,
+		.irq_pin		= SIW_HOST_IRQ,
+		.maker_id_pin	= -1,
+		.vdd_pin		= -1,
+		.vio_pin		= -1,
+	},
+	.caps				= {
+		.max_x			= SIW_HOST_MAX_X,
+		.max_y			= SIW_HOST_MAX_Y,
+		.max_pressure	= SIW_HOST_MAX_PRESSURE,
+		.max_width		= SIW_HOST_MAX_WIDTH,
+		.max_orientation = SIW_HOST_MAX_ORI,
+		.max_id			= SIW_HOST_MAX_ID,
+		.hw_reset_delay	= SIW_HOST_HW_RST_DELAY,
+		.sw_reset_delay	= SIW_HOST_SW_RST_DELAY,
+	},
+	/* Input Device ID */
+	.i_id				= {
+		.bustype		= BUS_I2C,
+		.vendor 		= 0xABCD,
+		.product 		= 0x9876,
+		.version 		= 0x1234,
+	},
+	.ops				= NULL,
+	.senseless_margin	= 0x21,
+};
+
+static struct siw_touch_chip_data chip_data = {
+	.pdata = &chip_pdata,
+	.bus_drv = NULL,
+};
+
+/* trace record, see siw_touch_emul.c */
+struct siw_host_emul_rec {
+	u32 ts_us;
+	struct siw_hal_touch_info info;
+} __packed;
+
+static void siw_host_trace_finger(struct siw_hal_touch_info *info,
+				int id, int event, int x, int y)
+{
+	struct siw_hal_touch_data *data = &info->data[info->touch_cnt++];
+
+	data->tool_type = 0;
+	data->event = event;
+	data->track_id = id;
+	data->x = x;
+	data->y = y;
+	data->pressure = 60 + id;
+	data->angle = 0;
+	data->width_major = 5;
+	data->width_minor = 5;
+}
+
+/*
+ * Two fingers : #0 down at frame 0, #1 down at frame 8,
+ * both moving, #1 up at frame 40, #0 up at frame 48,
+ * and one frame without touch count at frame 24 (an error on target)
+ */
+static int siw_host_trace_build(struct siw_host_emul_rec *rec, int max)
+{
+	struct siw_hal_touch_info *info;
+	int count = min(max, 49);
+	int i;
+
+	memset(rec, 0, sizeof(*rec) * count);
+
+	for (i = 0; i < count; i++, rec++) {
+		rec->ts_us = i * SIW_HOST_TRACE_STEP;
+
+		info = &rec->info;
+		info->ic_status = 0;
+		info->device_status = 0x06D580E7;
+		info->wakeup_type = ABS_MODE;
+
+		if (i == 24)
+			continue;
+
+		siw_host_trace_finger(info, 0,
+			(!i) ? TOUCHSTS_DOWN : (i < 48) ? TOUCHSTS_MOVE : TOUCHSTS_UP,
+			100 + (i * 8), 200 + (i * 16));
+
+		if ((i < 8) || (i > 40))
+			continue;
+
+		siw_host_trace_finger(info, 1,
+			(i == 8) ? TOUCHSTS_DOWN : (i < 40) ? TOUCHSTS_MOVE : TOUCHSTS_UP,
+			600 - (i * 8), 1000 - (i * 16));
+	}
+
+	return count;
+}
+
+static int siw_host_store(struct siw_ts *ts, const char *name, const char *val)
+{
+	ssize_t ret = siw_host_sysfs_store(&ts->kobj, name, val, strlen(val));
+
+	if (ret < 0) {
+		fprintf(stderr, "store %s failed, %zd\n", name, ret);
+		return (int)ret;
+	}
+	return 0;
+}
+
+static int siw_host_upload(struct siw_ts *ts, u8 *trace, int size)
+{
+	loff_t off = 0;
+	ssize_t ret;
+	int len;
+
+	/* in pages, as sysfs does */
+	while (off < size) {
+		len = min_t(int, size - off, PAGE_SIZE);
+		ret = siw_host_sysfs_write_bin(&ts->kobj, "emul_trace",
+					(char *)&trace[off], off, len);
+		if (ret != len) {
+			fprintf(stderr, "emul_trace write failed, %zd\n", ret);
+			return -EIO;
+		}
+		off += len;
+	}
+
+	return 0;
+}
+
+/*
+ * Keeps the lines of emul_replay not depending on the host speed
+ */
+static int siw_host_report_replay(struct siw_ts *ts, int *frames, int *errors)
+{
+	char *buf = kzalloc(PAGE_SIZE, GFP_KERNEL);
+	char *line, *next;
+
+	if (!buf)
+		return -ENOMEM;
+
+	if (siw_host_sysfs_show(&ts->kobj, "emul_replay", buf) < 0) {
+		kfree(buf);
+		return -ENOENT;
+	}
+
+	for (line = buf; line && *line; line = next) {
+		next = strchr(line, '\n');
+		if (next)
+			*next++ = 0;
+
+		sscanf(line, "frames  : %d (err %d)", frames, errors);
+
+		if (!strncmp(line, "elapsed", 7) || !strncmp(line, "cost", 4))
+			continue;
+
+		printf("replay  %s\n", line);
+	}
+
+	kfree(buf);
+
+	return 0;
+}
+
+/*
+ * Stage and count columns of the latency histogram
+ */
+static int siw_host_report_latency(void)
+{
+	char *buf = kzalloc(PAGE_SIZE, GFP_KERNEL);
+	char stage[32];
+	char *line, *next;
+	u32 cnt;
+
+	if (!buf)
+		return -ENOMEM;
+
+	if (siw_host_debugfs_read("latency", buf, PAGE_SIZE) < 0) {
+		kfree(buf);
+		return -ENOENT;
+	}
+
+	for (line = buf; line && *line; line = next) {
+		next = strchr(line, '\n');
+		if (next)
+			*next++ = 0;
+
+		if (sscanf(line, "%31s %u", stage, &cnt) == 2)
+			printf("latency %-10s %u\n", stage, cnt);
+	}
+
+	kfree(buf);
+
+	return 0;
+}
+
+static int siw_host_probe(struct siw_ts **pts)
+{
+	struct siw_ts *ts;
+	int ret;
+
+	ret = siw_touch_bus_add_driver(&chip_data);
+	if (ret < 0) {
+		fprintf(stderr, "probe failed, %d\n", ret);
+		return ret;
+	}
+
+	ts = siw_host_bus_ts();
+
+	/* hw reset delay, init work and what follows it */
+	siw_host_run_works(2 * NSEC_PER_SEC);
+
+	if (atomic_read(&ts->state.core) != CORE_NORMAL) {
+		fprintf(stderr, "init failed, core state %d\n",
+			atomic_read(&ts->state.core));
+		return -EIO;
+	}
+
+	printf("probe   %s, %s\n", touch_chip_name(ts), ts->input->name);
+
+	*pts = ts;
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	struct siw_host_emul_rec *trace;
+	struct siw_ts *ts = NULL;
+	int frames = 0;
+	int errors = 0;
+	int count;
+	int opt;
+	int ret;
+
+	while ((opt = getopt(argc, argv, "v:")) != -1) {
+		switch (opt) {
+		case 'v':
+			siw_host_log_level = simple_strtol(optarg, NULL, 0);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-v {log level}]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	setvbuf(stdout, NULL, _IOLBF, 0);
+
+	ret = siw_host_probe(&ts);
+	if (ret < 0)
+		goto out;
+
+	trace = kzalloc(sizeof(*trace) * SIW_HOST_TRACE_MAX, GFP_KERNEL);
+	if (!trace) {
+		ret = -ENOMEM;
+		goto out_remove;
+	}
+	count = siw_host_trace_build(trace, SIW_HOST_TRACE_MAX);
+
+	siw_host_evt_log = stdout;
+
+	ret = siw_host_store(ts, "bus_emul", "1");
+	if (!ret)
+		ret = siw_host_upload(ts, (u8 *)trace, sizeof(*trace) * count);
+	if (!ret)
+		ret = siw_host_store(ts, "emul_replay", "0");
+	if (!ret)
+		ret = siw_host_report_replay(ts, &frames, &errors);
+	if (!ret)
+		ret = siw_host_store(ts, "bus_emul", "0");
+
+	siw_host_evt_log = NULL;
+
+	kfree(trace);
+
+	if (!ret)
+		ret = siw_host_report_latency();
+
+	/* the only invalid frame is the one without touch count */
+	if (!ret && ((frames != count) || (errors != 1))) {
+		fprintf(stderr, "replay mismatch: frames %d/%d, err %d/1\n",
+			frames, count, errors);
+		ret = -EINVAL;
+	}
+
+out_remove:
+	siw_touch_bus_del_driver(&chip_data);
+
+out:
+	if (ret < 0) {
+		fprintf(stderr, "FAIL, %d\n", ret);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,23 @@
+/*
+ * siw_host_main.h - SiW touch host build, harness
+ *
+ * Copyright (C) 2016 Silicon Works - http://www.siliconworks.co.kr
+ * Author: Hyunho Kim <kimhh@siliconworks.co.kr>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#ifndef __SIW_HOST_MAIN_H
+#define __SIW_HOST_MAIN_H
+
+#define SIW_HOST_IRQ			2
+
+/* siw_host_bus.c */
+extern void siw_host_chip_set(u32 addr, u32 value);
+extern u32 siw_host_chip_get(u32 addr);
+extern void siw_host_chip_init(struct siw_hal_reg *reg);
+extern struct siw_ts *siw_host_bus_ts(void);
+
+#endif	/* __SIW_HOST_MAIN_H */
@@ -655,6 +655,9 @@ static void __used siw_touch_init_locks(struct siw_ts *ts)
 
 	mutex_init(&ts->lock);
 	mutex_init(&ts->reset_lock);
+#if defined(__SIW_SUPPORT_LAT_HIST)
+	spin_lock_init(&ts->lat.lock);
+#endif
 #if defined(__SIW_SUPPORT_WAKE_LOCK)
 	wake_lock_init(&ts->lpwg_wake_lock,
 		WAKE_LOCK_SUSPEND, SIW_TOUCH_LPWG_LOCK_NAME);
@@ -739,6 +742,12 @@ static void siw_touch_init_work_func(struct work_struct *work)
 	t_dev_dbg_base(dev, "init work done\n");
 }
 
+/*
+ * The image is fetched and checked with touch still alive
+ * (siw_ops_upgrade_prep) and only the sram/flash write window
+ * takes ts->lock with irq disabled (siw_ops_upgrade).
+ * Progress : /sys/.../fw_upgrade_stat
+ */
 static void siw_touch_upgrade_work_func(struct work_struct *work)
 {
 	struct siw_ts *ts =
@@ -749,15 +758,49 @@ static void siw_touch_upgrade_work_func(struct work_struct *work)
 
 	t_dev_info(dev, "FW upgrade work func\n");
 
-	atomic_set(&ts->state.core, CORE_UPGRADE);
 	ts->role.use_fw_upgrade = 0;
 
+	memset(&ts->fwup, 0, sizeof(ts->fwup));
+	siw_touch_fwup_phase(ts, FWUP_PHASE_LOAD);
+
+	if (!siw_ops_is_null(ts, upgrade_prep)) {
+		ret = siw_ops_upgrade_prep(ts);
+	}
+	if (ret < 0) {
+		/* touch was not taken */
+		ts->force_fwup = FORCE_FWUP_CLEAR;
+		ts->test_fwpath[0] = '\0';
+
+		ts->fwup.result = ret;
+		siw_touch_fwup_phase(ts, FWUP_PHASE_DONE);
+
+		if (ret == -EPERM) {
+			t_dev_info(dev, "FW upgrade skipped\n");
+		} else {
+			t_dev_info(dev, "FW upgrade halted, %d\n", ret);
+		}
+
+		/* still in probe stage */
+		if (atomic_read(&ts->state.core) != CORE_NORMAL) {
+			atomic_set(&ts->state.core, CORE_UPGRADE);
+			siw_touch_qd_init_work_now(ts);
+		}
+		return;
+	}
+
+	siw_touch_fwup_phase(ts, FWUP_PHASE_CUTOVER);
+
+	atomic_set(&ts->state.core, CORE_UPGRADE);
+
 	mutex_lock(&ts->lock);
 	siw_touch_irq_control(dev, INTERRUPT_DISABLE);
 
 	ret = siw_ops_upgrade(ts);
 	mutex_unlock(&ts->lock);
 
+	ts->fwup.result = ret;
+	siw_touch_fwup_phase(ts, FWUP_PHASE_DONE);
+
 	/* init force_upgrade */
 	ts->force_fwup = FORCE_FWUP_CLEAR;
 	ts->test_fwpath[0] = '\0';
@@ -1095,6 +1138,17 @@ static int __used siw_touch_init_works(struct siw_ts *ts)
 		return -ENOMEM;
 	}
 
+	/* input reporting, see siw_touch_report_work_func */
+	ts->report_wq = alloc_ordered_workqueue("touch_report_wq", WQ_HIGHPRI);
+	if (!ts->report_wq) {
+		t_dev_err(ts->dev, "failed to create report workqueue\n");
+		destroy_workqueue(ts->wq);
+		ts->wq = NULL;
+		return -ENOMEM;
+	}
+
+	INIT_WORK(&ts->report_work, siw_touch_report_work_func);
+
 	INIT_DELAYED_WORK(&ts->init_work, siw_touch_init_work_func);
 	INIT_DELAYED_WORK(&ts->upgrade_work, siw_touch_upgrade_work_func);
 	INIT_DELAYED_WORK(&ts->fb_work, siw_touch_fb_work_func);
@@ -1127,6 +1181,12 @@ static void __used siw_touch_free_works(struct siw_ts *ts)
 		ts->wq = NULL;
 	}
 
+	if (ts->report_wq) {
+		cancel_work_sync(&ts->report_work);
+		destroy_workqueue(ts->report_wq);
+		ts->report_wq = NULL;
+	}
+
 	siw_touch_free_thread(ts);
 }
 
@@ -1147,6 +1207,9 @@ static irqreturn_t __used siw_touch_irq_handler(int irq, void *dev_id)
 		return IRQ_HANDLED;
 	}
 
+	ts->irq_ktime = ktime_get();
+	siw_touch_lat_stamp(ts, SIW_LAT_IRQ);
+
 	return IRQ_WAKE_THREAD;
 }
 
@@ -1209,9 +1272,8 @@ out:
 	return ret;
 }
 
-static irqreturn_t __used siw_touch_irq_thread(int irq, void *dev_id)
+static int __siw_touch_irq_thread(struct siw_ts *ts)
 {
-	struct siw_ts *ts = (struct siw_ts *)dev_id;
 	struct device *dev = ts->dev;
 	int ret = 0;
 
@@ -1221,14 +1283,42 @@ static irqreturn_t __used siw_touch_irq_thread(int irq, void *dev_id)
 		goto out;
 	}
 
+	/* input reporting is left to ts->report_work */
 	mutex_lock(&ts->lock);
 	ret = _siw_touch_do_irq_thread(ts);
 	mutex_unlock(&ts->lock);
 
 out:
+	siw_touch_lat_commit(ts);
+
+	return ret;
+}
+
+static irqreturn_t __used siw_touch_irq_thread(int irq, void *dev_id)
+{
+	struct siw_ts *ts = (struct siw_ts *)dev_id;
+
+	__siw_touch_irq_thread(ts);
+
 	return IRQ_HANDLED;
 }
 
+#if defined(__SIW_SUPPORT_EMUL)
+/*
+ * One interrupt of the bus emulation (siw_touch_emul.c),
+ * handler and thread in a row as the irq core runs them.
+ * The real irq is held disabled while emulating.
+ */
+int siw_touch_emul_irq(struct siw_ts *ts)
+{
+	if (siw_touch_irq_handler(ts->irq, ts) != IRQ_WAKE_THREAD) {
+		return -EBUSY;
+	}
+
+	return __siw_touch_irq_thread(ts);
+}
+#endif	/* __SIW_SUPPORT_EMUL */
+
 static int __used siw_touch_verify_pdata(struct siw_ts *ts)
 {
 	struct siw_touch_operations *ops = ts->ops;
@@ -40,6 +40,11 @@
 #include <linux/wakelock.h>
 #endif
 
+#if defined(__SIW_SUPPORT_LAT_HIST)
+#include <linux/ktime.h>
+#include <linux/spinlock.h>
+#endif
+
 #include <linux/input/siw_touch_notify.h>
 
 #include "siw_touch_hal_reg.h"
@@ -58,6 +63,7 @@ enum {
 enum {
 	SIW_TOUCH_MAX_BUF_SIZE		= (32<<10),	//(64<<10),
 	SIW_TOUCH_MAX_BUF_IDX		= 4,
+	SIW_TOUCH_IRQ_BUF_SIZE		= (1<<10),
 	/* */
 	SIW_TOUCH_MAX_XFER_COUNT	= 10,
 };
@@ -396,6 +402,112 @@ struct touch_data {
 	u16 event;
 };
 
+/*
+ * Touch-to-input latency (__SIW_SUPPORT_LAT_HIST)
+ */
+enum {
+	SIW_LAT_IRQ = 0,		/* siw_touch_irq_handler */
+	SIW_LAT_RD_START,		/* before bus read */
+	SIW_LAT_RD_END,			/* after bus read */
+	SIW_LAT_DECODE,			/* after decoding */
+	SIW_LAT_REPORT,			/* input_sync */
+	SIW_LAT_STAMP_MAX,
+};
+
+/*
+ * Decoded touch frame handed from the irq thread to the reporter
+ */
+struct siw_touch_frame {
+	u16 new_mask;
+	u16 tcount;
+	u8 is_palm;
+	u8 flags;
+	struct touch_data tdata[MAX_FINGER];
+#if defined(__SIW_SUPPORT_LAT_HIST)
+	/* stamps of the irq, committed by the reporter */
+	ktime_t lat_stamp[SIW_LAT_STAMP_MAX];
+	u32 lat_valid;
+#endif
+};
+
+enum {
+	SIW_TOUCH_FRAME_RELEASE_ALL	= (1<<0),
+};
+
+enum {
+	SIW_TOUCH_FRAME_RING_SZ		= 8,	/* power of 2 */
+};
+
+/*
+ * Single-producer / single-consumer ring
+ * producer : ts->lock holder (irq thread, control paths)
+ * consumer : ts->report_work, the only one draining it (no lock)
+ */
+struct siw_touch_frame_ring {
+	struct siw_touch_frame frame[SIW_TOUCH_FRAME_RING_SZ];
+	unsigned int head;
+	unsigned int tail;
+	u32 overrun;
+};
+
+/*
+ * Delta reporting statistics (ts->report_work)
+ */
+struct siw_touch_report_stat {
+	u32 frames;
+	u32 dropped;
+	u32 emitted;
+	u32 suppressed;
+};
+
+/*
+ * F/W upgrade progress (upgrade_work only)
+ */
+enum {
+	FWUP_PHASE_IDLE = 0,
+	FWUP_PHASE_LOAD,		/* image fetch, touch alive */
+	FWUP_PHASE_CHECK,		/* size, version and block crc, touch alive */
+	FWUP_PHASE_CUTOVER,		/* waiting for ts->lock */
+	FWUP_PHASE_CODE,		/* code sram download and verify */
+	FWUP_PHASE_FLASH,		/* code flash and boot check */
+	FWUP_PHASE_CONF,		/* conf download and flash */
+	FWUP_PHASE_DONE,
+	FWUP_PHASE_MAX,
+};
+
+struct siw_touch_fwup_stat {
+	int phase;
+	int result;
+	u32 dn_total;			/* bytes to be written in this upgrade */
+	u32 dn_done;
+	ktime_t t_phase;
+	u32 phase_ms[FWUP_PHASE_MAX];
+};
+
+#if defined(__SIW_SUPPORT_LAT_HIST)
+enum {
+	SIW_LAT_HIST_BINS	= 32,	/* log2(ns) */
+};
+
+struct siw_touch_lat_hist {
+	u32 bin[SIW_LAT_HIST_BINS];
+	u32 cnt;
+	u64 max;
+};
+
+struct siw_touch_lat {
+	/*
+	 * hist[0] : total, irq to report
+	 * hist[n] : stamp[n-1] to stamp[n]
+	 */
+	struct siw_touch_lat_hist hist[SIW_LAT_STAMP_MAX];
+	ktime_t stamp[SIW_LAT_STAMP_MAX];
+	u32 valid;
+	spinlock_t lock;
+	void *root;		/* debugfs dentry */
+};
+#endif	/* __SIW_SUPPORT_LAT_HIST */
+
 struct point {
 	int x;
 	int y;
@@ -474,6 +586,7 @@ struct siw_touch_operations {
 	int (*irq_abs)(struct device *dev);
 	int (*irq_lpwg)(struct device *dev);
 	int (*power)(struct device *dev, int power_mode);
+	int (*upgrade_prep)(struct device *dev);
 	int (*upgrade)(struct device *dev);
 	int (*lpwg)(struct device *dev,	u32 code, void *param);
 	int (*asc)(struct device *dev, u32 code, u32 value);
@@ -629,6 +742,7 @@ struct siw_touch_pdata {
 
 	unsigned long quirks;
 #define _CHIP_QUIRK_NOT_SUPPORT_XFER		(1L<<0)
+#define _CHIP_QUIRK_NOT_SUPPORT_FW_BURST	(1L<<1)	/* code window doesn't auto-increment over 1K */
 
 #define _CHIP_QUIRK_NOT_SUPPORT_ASC			(1L<<16)
 #define _CHIP_QUIRK_NOT_SUPPORT_LPWG		(1L<<17)
@@ -684,6 +798,7 @@ struct siw_touch_chip_data {
 
 enum {
 	CHIP_QUIRK_NOT_SUPPORT_XFER			= _CHIP_QUIRK_NOT_SUPPORT_XFER,
+	CHIP_QUIRK_NOT_SUPPORT_FW_BURST		= _CHIP_QUIRK_NOT_SUPPORT_FW_BURST,
 	/* */
 	CHIP_QUIRK_NOT_SUPPORT_ASC			= _CHIP_QUIRK_NOT_SUPPORT_ASC,
 	CHIP_QUIRK_NOT_SUPPORT_LPWG			= _CHIP_QUIRK_NOT_SUPPORT_LPWG,
@@ -974,6 +1089,20 @@ struct siw_ts {
 	int tcount;
 	struct touch_data tdata[MAX_FINGER];
 	int is_palm;
+	struct siw_touch_frame_ring fring;
+	struct workqueue_struct *report_wq;
+	struct work_struct report_work;
+	struct touch_data rpt_tdata[MAX_FINGER];	/* last reported, per slot */
+	struct siw_touch_report_stat rpt_stat;
+	int rpt_stat_clr;
+	u32 abs_evt_cnt;
+	ktime_t irq_ktime;		/* hard irq edge */
+#if defined(__SIW_SUPPORT_LAT_HIST)
+	struct siw_touch_lat lat;
+#endif
+#if defined(__SIW_SUPPORT_EMUL)
+	void *emul;
+#endif
 	struct lpwg_info lpwg;
 	struct tci_ctrl tci;
 	struct asc_info asc;
@@ -984,6 +1113,7 @@ struct siw_ts {
 	const char *panel_spec;
 	const char *panel_spec_mfts;
 	u32 force_fwup;
+	struct siw_touch_fwup_stat fwup;
 #define _FORCE_FWUP_CLEAR		0
 #define _FORCE_FWUP_ON			(1<<0)
 #define _FORCE_FWUP_SYS_SHOW	(1<<2)
@@ -1009,6 +1139,8 @@ struct siw_ts {
 	struct siw_touch_buf rx_buf[SIW_TOUCH_MAX_BUF_IDX];
 	int tx_buf_idx;
 	int rx_buf_idx;
+	struct siw_touch_buf tx_buf_irq;
+	struct siw_touch_buf rx_buf_irq;
 
 	struct mutex lock;
 	struct mutex reset_lock;
@@ -1045,6 +1177,7 @@ struct siw_ts {
 	u32 flags;
 #define _IRQ_USE_WAKE				(1UL<<0)	/* unavailable */
 #define _IRQ_USE_SCHEDULE_WORK		(1UL<<1)
+#define _IRQ_USE_ZERO_COPY			(1UL<<2)
 
 #define _TOUCH_USE_MON_THREAD		(1UL<<8)
 #define _TOUCH_USE_PINCTRL			(1UL<<9)
@@ -1097,6 +1230,7 @@ enum {
 enum {
 	IRQ_USE_WAKE				= _IRQ_USE_WAKE,
 	IRQ_USE_SCHEDULE_WORK		= _IRQ_USE_SCHEDULE_WORK,
+	IRQ_USE_ZERO_COPY			= _IRQ_USE_ZERO_COPY,
 	/* */
 	TOUCH_USE_MON_THREAD		= _TOUCH_USE_MON_THREAD,
 	TOUCH_USE_PINCTRL			= _TOUCH_USE_PINCTRL,
@@ -1527,6 +1661,7 @@ static inline void siw_ops_restore_irq_handler(struct siw_ts *ts)
 #define siw_ops_irq_abs(_ts, args...)		siw_ops_xxx(irq_abs, -ESRCH, _ts, ##args)
 #define siw_ops_irq_lpwg(_ts, args...)		siw_ops_xxx(irq_lpwg, -ESRCH, _ts, ##args)
 #define siw_ops_power(_ts, args...)			siw_ops_xxx(power, -ESRCH, _ts, ##args)
+#define siw_ops_upgrade_prep(_ts, args...)	siw_ops_xxx(upgrade_prep, 0, _ts, ##args)
 #define siw_ops_upgrade(_ts, args...)		siw_ops_xxx(upgrade, -ESRCH, _ts, ##args)
 #define siw_ops_lpwg(_ts, args...)			siw_ops_xxx(lpwg, 0, _ts, ##args)
 #define siw_ops_asc(_ts, args...)			siw_ops_xxx(asc, -ESRCH, _ts, ##args)
@@ -1541,6 +1676,30 @@ static inline void siw_ops_restore_irq_handler(struct siw_ts *ts)
 #define siw_ops_watch_sysfs(_ts, args...)	siw_ops_xxx(watch_sysfs, 0, _ts, ##args)
 
 
+static inline void siw_touch_fwup_phase(struct siw_ts *ts, int phase)
+{
+	struct siw_touch_fwup_stat *fwup = &ts->fwup;
+	ktime_t now = ktime_get();
+
+	if ((fwup->phase > FWUP_PHASE_IDLE) && (fwup->phase < FWUP_PHASE_DONE)) {
+		fwup->phase_ms[fwup->phase] +=
+			(u32)ktime_to_ms(ktime_sub(now, fwup->t_phase));
+	}
+	fwup->phase = phase;
+	fwup->t_phase = now;
+}
+
+static inline void siw_touch_fwup_dn_total(struct siw_ts *ts, u32 size)
+{
+	ts->fwup.dn_total = size;
+	ts->fwup.dn_done = 0;
+}
+
+static inline void siw_touch_fwup_dn_done(struct siw_ts *ts, u32 size)
+{
+	ts->fwup.dn_done += size;
+}
+
 static inline void touch_msleep(unsigned int msecs)
 {
 	if (!msecs)
@@ -1695,6 +1854,25 @@ static inline void siwmon_submit_ops(struct device *dev, char *ops, void *data,
 
 #endif	/* CONFIG_TOUCHSCREEN_SIWMON */
 
+#if defined(__SIW_SUPPORT_LAT_HIST)
+static inline void siw_touch_lat_stamp(struct siw_ts *ts, int stage)
+{
+	ts->lat.stamp[stage] = ktime_get();
+	ts->lat.valid |= (1<<stage);
+}
+
+extern void __siw_touch_lat_commit(struct siw_ts *ts, ktime_t *stamp, u32 valid);
+extern void siw_touch_lat_commit(struct siw_ts *ts);
+#else
+static inline void siw_touch_lat_stamp(struct siw_ts *ts, int stage){ }
+static inline void siw_touch_lat_commit(struct siw_ts *ts){ }
+#endif
+
+#if defined(__SIW_SUPPORT_EMUL)
+extern int siw_touch_emul_load(struct device *dev, u32 addr, void *data, int size);
+extern int siw_touch_emul_irq(struct siw_ts *ts);
+#endif
+
 #define siwmon_submit_ops_wh_name(_dev, _fmt, _name, _val, _size, _ret)	\
 		do {	\
 			char _mstr[64];	\
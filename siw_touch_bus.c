@@ -322,6 +322,59 @@ out:
 	return -ENOMEM;
 }
 
+static void siw_touch_irq_buf_free(struct siw_ts *ts)
+{
+	struct device *dev = ts->dev;
+	struct siw_touch_buf *t_buf;
+
+	t_buf = &ts->rx_buf_irq;
+	__buffer_free(dev, t_buf->size, t_buf->buf, t_buf->dma, "rx_buf_irq");
+	memset(t_buf, 0, sizeof(*t_buf));
+
+	t_buf = &ts->tx_buf_irq;
+	__buffer_free(dev, t_buf->size, t_buf->buf, t_buf->dma, "tx_buf_irq");
+	memset(t_buf, 0, sizeof(*t_buf));
+}
+
+/*
+ * Dedicated slots for the irq thread
+ * These are never rotated by the normal reg access,
+ * so the touch report can be decoded in place after the bus read
+ */
+static int siw_touch_irq_buf_alloc(struct siw_ts *ts)
+{
+	struct device *dev = ts->dev;
+	struct siw_touch_buf *t_buf;
+	u8 *buf;
+	dma_addr_t dma;
+
+	t_buf = &ts->tx_buf_irq;
+	buf = __buffer_alloc(dev, SIW_TOUCH_IRQ_BUF_SIZE, &dma,
+				GFP_KERNEL | GFP_DMA, "tx_buf_irq");
+	if (!buf) {
+		goto out;
+	}
+	t_buf->buf = buf;
+	t_buf->dma = dma;
+	t_buf->size = SIW_TOUCH_IRQ_BUF_SIZE;
+
+	t_buf = &ts->rx_buf_irq;
+	buf = __buffer_alloc(dev, SIW_TOUCH_IRQ_BUF_SIZE, &dma,
+				GFP_KERNEL | GFP_DMA, "rx_buf_irq");
+	if (!buf) {
+		goto out;
+	}
+	t_buf->buf = buf;
+	t_buf->dma = dma;
+	t_buf->size = SIW_TOUCH_IRQ_BUF_SIZE;
+
+	return 0;
+
+out:
+	siw_touch_irq_buf_free(ts);
+	return -ENOMEM;
+}
+
 int siw_touch_bus_alloc_buffer(struct siw_ts *ts)
 {
 	struct device *dev = ts->dev;
@@ -349,17 +402,38 @@ int siw_touch_bus_alloc_buffer(struct siw_ts *ts)
 		goto out_rx_buf;
 	}
 
+	ret = siw_touch_irq_buf_alloc(ts);
+	if (ret < 0) {
+		goto out_irq_buf;
+	}
+
 	xfer = __buffer_alloc(dev, sizeof(struct touch_xfer_msg),
 					NULL, GFP_KERNEL, "xfer");
 	if (!xfer) {
 		ret = -ENOMEM;
 		goto out_xfer;
 	}
+	memset(xfer, 0, sizeof(struct touch_xfer_msg));
+
+	xfer->pool = __buffer_alloc(dev, buf_size, &xfer->pool_dma,
+					GFP_KERNEL | GFP_DMA, "xfer_pool");
+	if (!xfer->pool) {
+		ret = -ENOMEM;
+		goto out_xfer_pool;
+	}
+	xfer->pool_size = buf_size;
 	ts->xfer = xfer;
 
 	return 0;
 
+out_xfer_pool:
+	__buffer_free(dev, sizeof(struct touch_xfer_msg),
+			xfer, 0, "xfer");
+
 out_xfer:
+	siw_touch_irq_buf_free(ts);
+
+out_irq_buf:
 	siw_touch_buf_alloc(ts, 0);
 
 out_rx_buf:
@@ -377,11 +451,15 @@ int siw_touch_bus_free_buffer(struct siw_ts *ts)
 	t_dev_dbg_base(dev, "release touch bus buffer\n");
 
 	if (ts->xfer) {
+		__buffer_free(dev, ts->xfer->pool_size,
+				ts->xfer->pool, ts->xfer->pool_dma, "xfer_pool");
 		__buffer_free(dev, sizeof(struct touch_xfer_msg),
 				ts->xfer, 0, "xfer");
 		ts->xfer = NULL;
 	}
 
+	siw_touch_irq_buf_free(ts);
+
 	siw_touch_buf_free(ts, 0);
 	siw_touch_buf_free(ts, 1);
 
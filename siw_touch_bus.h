@@ -19,6 +19,7 @@
 #include <linux/gpio.h>
 #include <linux/interrupt.h>
 #include <linux/irq.h>
+#include <linux/cache.h>
 
 
 enum {
@@ -61,24 +62,62 @@ struct touch_bus_msg {
 	int priv;
 };
 
+enum {
+	SIW_TOUCH_XFER_HDR_SZ = (SPI_BUS_TX_HDR_SZ + SPI_BUS_RX_DUMMY_SZ_128BIT),
+};
+
+/*
+ * buf  : caller buffer
+ * data : payload in the pooled bus buffer (touch_xfer_msg.pool)
+ * size : payload size
+ */
 struct touch_xfer_data_t {
 	u16 addr;
 	u16 size;
 	u8 *buf;
-	u8 data[SIW_TOUCH_MAX_BUF_SIZE];
+	u8 *data;
 };
 
+/*
+ * hdr : bus header (and rx dummy) sent ahead of the payload
+ *       in the same chip select
+ */
 struct touch_xfer_data {
 	struct touch_xfer_data_t tx;
 	struct touch_xfer_data_t rx;
+	u8 hdr[SIW_TOUCH_XFER_HDR_SZ];
+	u8 hdr_size;
 };
 
 struct touch_xfer_msg {
 	struct touch_xfer_data data[SIW_TOUCH_MAX_XFER_COUNT];
 	u8 bits_per_word;
 	u8 msg_count;
+	/* bus buffer shared by all descriptors of a message */
+	u8 *pool;
+	dma_addr_t pool_dma;
+	int pool_size;
+	int pool_used;
 };
 
+/*
+ * Payloads are cache line aligned not to share a line
+ * between tx and rx regions
+ */
+static inline u8 *touch_xfer_pool_get(struct touch_xfer_msg *xfer, int size)
+{
+	u8 *buf;
+
+	size = L1_CACHE_ALIGN(size);
+	if ((xfer->pool_used + size) > xfer->pool_size)
+		return NULL;
+
+	buf = &xfer->pool[xfer->pool_used];
+	xfer->pool_used += size;
+
+	return buf;
+}
+
 struct siw_touch_bus_drv {
 	union {
 		struct i2c_driver i2c_drv;
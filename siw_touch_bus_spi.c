@@ -214,6 +214,7 @@ static void __siw_touch_spi_xfer_mon(struct spi_device *spi,
 				struct touch_xfer_msg *xfer,
 				int ret)
 {
+	struct touch_xfer_data *d = NULL;
 	struct touch_xfer_data_t *tx = NULL;
 	struct touch_xfer_data_t *rx = NULL;
 	struct touch_bus_msg *msg;
@@ -223,14 +224,16 @@ static void __siw_touch_spi_xfer_mon(struct spi_device *spi,
 	int i;
 
 	for (i = 0; i < cnt; i++) {
-		tx = &xfer->data[i].tx;
-		rx = &xfer->data[i].rx;
+		d = &xfer->data[i];
+		tx = &d->tx;
+		rx = &d->rx;
 
+		/* tx : header, rx : payload (read or written) */
 		msg = &msg_buf[idx++];
-		msg->tx_buf = tx->data;
-		msg->tx_size = tx->size;
-		msg->rx_buf = rx->data;
-		msg->rx_size = rx->size;
+		msg->tx_buf = d->hdr;
+		msg->tx_size = d->hdr_size;
+		msg->rx_buf = (rx->size) ? rx->data : tx->data;
+		msg->rx_size = (rx->size) ? rx->size : tx->size;
 		msg->bits_per_word = spi->bits_per_word;
 		msg->priv = (i<<8) | cnt;
 
@@ -249,12 +252,14 @@ static int siw_touch_spi_do_xfer(struct spi_device *spi, struct touch_xfer_msg *
 {
 //	struct siw_ts *ts = spi_get_drvdata(spi);
 	struct device *dev = &spi->dev;
+	struct touch_xfer_data *d = NULL;
 	struct touch_xfer_data_t *tx = NULL;
 	struct touch_xfer_data_t *rx = NULL;
-	struct spi_transfer _x[SIW_TOUCH_MAX_XFER_COUNT];
+	struct spi_transfer _x[SIW_TOUCH_MAX_XFER_COUNT<<1];
 	struct spi_transfer *x;
 	struct spi_message m;
 	int cnt = xfer->msg_count;
+	int num = 0;
 	int i = 0;
 	int ret = 0;
 
@@ -276,19 +281,31 @@ static int siw_touch_spi_do_xfer(struct spi_device *spi, struct touch_xfer_msg *
 
 	memset(_x, 0, sizeof(_x));
 
+	/*
+	 * Each descriptor is sent as two transfers in one chip select :
+	 * the header(+dummy) from the side area and the payload in the pool
+	 */
 	x = _x;
 	for (i = 0; i < cnt; i++) {
-		tx = &xfer->data[i].tx;
-		rx = &xfer->data[i].rx;
+		d = &xfer->data[i];
+		tx = &d->tx;
+		rx = &d->rx;
 
-		x->cs_change = !!(i < (xfer->msg_count - 1));
-	//	x->cs_change = 1;
+		x->cs_change = 0;
 		x->bits_per_word = spi->bits_per_word;
 		x->delay_usecs = 0;
 		x->speed_hz = spi->max_speed_hz;
+		x->tx_buf = d->hdr;
+		x->rx_buf = NULL;
+		x->len = d->hdr_size;
+
+		siw_touch_spi_message_add_tail(spi, x, &m);
+
+		x++;
+		num++;
 
 		if (rx->size) {
-			x->tx_buf = tx->data;
+			x->tx_buf = NULL;
 			x->rx_buf = rx->data;
 			x->len = rx->size;
 		} else {
@@ -304,15 +321,25 @@ static int siw_touch_spi_do_xfer(struct spi_device *spi, struct touch_xfer_msg *
 			break;
 		}
 
-		siw_touch_spi_message_add_tail(spi, x, &m);
+		if (x->len) {
+			x->bits_per_word = spi->bits_per_word;
+			x->delay_usecs = 0;
+			x->speed_hz = spi->max_speed_hz;
 
-		x++;
+			siw_touch_spi_message_add_tail(spi, x, &m);
+
+			x++;
+			num++;
+		}
+
+		(x - 1)->cs_change = !!(i < (xfer->msg_count - 1));
+	//	(x - 1)->cs_change = 1;
 	}
 
 	ret = siw_touch_spi_sync(spi, &m);
 	__siw_touch_spi_xfer_mon(spi, xfer, ret);
 	if (ret < 0)
-		siw_touch_spi_err_dump(spi, _x, cnt, 0);
+		siw_touch_spi_err_dump(spi, _x, num, 0);
 
 	return ret;
 }
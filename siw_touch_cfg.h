@@ -71,6 +71,14 @@
 
 //#define __SIW_SUPPORT_PM_QOS
 
+#if defined(CONFIG_DEBUG_FS)
+#define __SIW_SUPPORT_LAT_HIST
+#endif
+
+#if defined(CONFIG_TOUCHSCREEN_SIW_EMUL)
+#define __SIW_SUPPORT_EMUL
+#endif
+
 #if defined(CONFIG_OF)
 #define __SIW_CONFIG_OF
 #endif
@@ -124,5 +132,10 @@ enum _SIW_CHIP_TYPE {
 #define subsys_system_register(_subsys, _group)	bus_register(_subsys)
 #endif
 
+#if (LINUX_VERSION_CODE < KERNEL_VERSION(3, 19, 0))
+#define READ_ONCE(_x)			ACCESS_ONCE(_x)
+#define WRITE_ONCE(_x, _val)	(ACCESS_ONCE(_x) = (_val))
+#endif
+
 #endif	/* __SIW_TOUCH_CFG_H */
 
@@ -0,0 +1,699 @@
+/*
+ * siw_touch_emul.c - SiW touch bus emulation
+ *
+ * Copyright (C) 2016 Silicon Works - http://www.siliconworks.co.kr
+ * Author: Hyunho Kim <kimhh@siliconworks.co.kr>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#include "siw_touch_cfg.h"
+
+#if defined(__SIW_SUPPORT_EMUL)	//See siw_touch_cfg.h
+
+#include <linux/kernel.h>
+#include <linux/types.h>
+#include <linux/module.h>
+#include <linux/moduleparam.h>
+#include <linux/delay.h>
+#include <linux/err.h>
+#include <linux/sched.h>
+#include <linux/input.h>
+#include <linux/slab.h>
+#include <linux/vmalloc.h>
+#include <linux/string.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <asm/uaccess.h>
+
+#include "siw_touch.h"
+#include "siw_touch_hal.h"
+#include "siw_touch_bus.h"
+#include "siw_touch_event.h"
+#include "siw_touch_irq.h"
+
+/*
+ * Bus emulation layer
+ * Replaces bus_read/bus_write/bus_xfer of the core with a simulated
+ * register file, so that the hal (siw_hal_irq_handler, decoding and
+ * reporting) can run on recorded data without the touch IC.
+ *
+ * - register file : 12-bit word address space (0x000 ~ 0xFFF)
+ * - serial_data_offset / data_i2cbase_addr : indirect access to sram
+ *   (offset in word)
+ * - __SIW_I2C_TYPE_1 : the host-side address fix-up is undone here
+ *
+ * The real irq and the monitor thread are held while emulating.
+ *
+ * Trace replay
+ * A recorded session (struct siw_touch_emul_rec per irq) is uploaded
+ * via emul_trace and each frame is loaded at tc_ic_status, then run
+ * through the irq handler and thread of the core (siw_touch_emul_irq),
+ * so the core state check and the latency stamps apply as on target.
+ * Throughput, per-frame cost and the number of ABS events are reported.
+ */
+
+enum {
+	SIW_EMUL_REG_NUM	= (1<<12),
+	SIW_EMUL_REG_SIZE	= (SIW_EMUL_REG_NUM<<2),
+	SIW_EMUL_SRAM_SIZE	= (64<<10),
+	SIW_EMUL_TRACE_MAX	= (4<<20),
+	SIW_EMUL_RATE_MAX	= 1000,
+};
+
+/* trace record, as captured per irq */
+struct siw_touch_emul_rec {
+	u32 ts_us;
+	struct siw_hal_touch_info info;
+} __packed;
+
+struct siw_touch_emul_result {
+	u32 frames;
+	u32 errors;
+	u32 rate;
+	u32 abs_evt;
+	u64 elapsed_ns;
+	u64 cost_ns;
+	u64 cost_max_ns;
+};
+
+struct siw_touch_emul {
+	struct device *dev;
+	/* saved bus ops */
+	int (*bus_read)(struct device *dev, void *msg);
+	int (*bus_write)(struct device *dev, void *msg);
+	int (*bus_xfer)(struct device *dev, void *xfer);
+	/* */
+	u8 *reg;
+	u8 *sram;
+	u32 sram_offs;
+	/* */
+	u32 rd_cnt;
+	u32 wr_cnt;
+	u64 rd_bytes;
+	u64 wr_bytes;
+	/* */
+	u8 *trace;
+	int trace_size;
+	struct siw_touch_emul_result result;
+};
+
+static DEFINE_MUTEX(siw_emul_lock);
+
+static inline u32 siw_emul_hdr_addr(u8 *hdr)
+{
+	return ((hdr[0] & 0x0F)<<8) | hdr[1];
+}
+
+static u32 siw_emul_map_addr(struct siw_ts *ts, u32 addr, int size)
+{
+#if defined(__SIW_I2C_TYPE_1)
+	struct siw_hal_reg *reg = siw_ops_reg(ts);
+
+	if (touch_bus_type(ts) == BUS_IF_I2C) {
+		if ((size > 4) && (addr == (reg->tc_ic_status + 1)))
+			return reg->tc_ic_status;
+		if ((size <= 4) && (addr == (reg->tc_status + 1)))
+			return reg->tc_status;
+	}
+#endif
+	return addr;
+}
+
+/*
+ * addr : word address into dst, from sysfs and from the bus,
+ *        anything beyond dst_size is dropped (write) or zero (read)
+ */
+static void siw_emul_copy(u8 *dst, size_t dst_size, u32 addr,
+				u8 *src, int size, int rd)
+{
+	size_t offs = 0;
+	size_t len = 0;
+
+	if ((size > 0) && (addr < (dst_size >> 2))) {
+		offs = (size_t)addr << 2;
+		len = min_t(size_t, size, dst_size - offs);
+	}
+
+	if (rd) {
+		/* dst is the storage */
+		if (len)
+			memcpy(src, &dst[offs], len);
+		if (size > (int)len)
+			memset(&src[len], 0, size - (int)len);
+	} else {
+		if (len)
+			memcpy(&dst[offs], src, len);
+	}
+}
+
+static void siw_emul_do_read(struct siw_ts *ts, u32 addr, u8 *buf, int size)
+{
+	struct siw_touch_emul *emul = ts->emul;
+	struct siw_hal_reg *reg = siw_ops_reg(ts);
+
+	addr = siw_emul_map_addr(ts, addr, size);
+
+	if (addr == reg->data_i2cbase_addr) {
+		siw_emul_copy(emul->sram, SIW_EMUL_SRAM_SIZE,
+				emul->sram_offs, buf, size, 1);
+	} else {
+		siw_emul_copy(emul->reg, SIW_EMUL_REG_SIZE,
+				addr, buf, size, 1);
+	}
+
+	emul->rd_cnt++;
+	emul->rd_bytes += size;
+}
+
+static void siw_emul_do_write(struct siw_ts *ts, u32 addr, u8 *buf, int size)
+{
+	struct siw_touch_emul *emul = ts->emul;
+	struct siw_hal_reg *reg = siw_ops_reg(ts);
+
+	if (addr == reg->serial_data_offset) {
+		memcpy(&emul->sram_offs, buf, min_t(int, size, sizeof(u32)));
+	} else if (addr == reg->data_i2cbase_addr) {
+		siw_emul_copy(emul->sram, SIW_EMUL_SRAM_SIZE,
+				emul->sram_offs, buf, size, 0);
+	} else {
+		siw_emul_copy(emul->reg, SIW_EMUL_REG_SIZE,
+				addr, buf, size, 0);
+	}
+
+	emul->wr_cnt++;
+	emul->wr_bytes += size;
+}
+
+static int siw_emul_rx_offs(struct siw_ts *ts, int tx_size)
+{
+	/* header + dummy on SPI */
+	return (touch_bus_type(ts) == BUS_IF_SPI) ?
+			tx_size : touch_rx_hdr_size(ts);
+}
+
+static int siw_emul_bus_read(struct device *dev, void *msg_data)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+	struct touch_bus_msg *msg = msg_data;
+	int offs = siw_emul_rx_offs(ts, msg->tx_size);
+	int size = msg->rx_size - offs;
+
+	if ((msg->tx_size < 2) || (size < 0)) {
+		return -EINVAL;
+	}
+
+	siw_emul_do_read(ts, siw_emul_hdr_addr(msg->tx_buf),
+			&msg->rx_buf[offs], size);
+
+	return 0;
+}
+
+static int siw_emul_bus_write(struct device *dev, void *msg_data)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+	struct touch_bus_msg *msg = msg_data;
+	int offs = touch_tx_hdr_size(ts);
+	int size = msg->tx_size - offs;
+
+	if ((msg->tx_size < 2) || (size < 0)) {
+		return -EINVAL;
+	}
+
+	siw_emul_do_write(ts, siw_emul_hdr_addr(msg->tx_buf),
+			&msg->tx_buf[offs], size);
+
+	return 0;
+}
+
+static int siw_emul_bus_xfer(struct device *dev, void *xfer_data)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+	struct touch_xfer_msg *xfer = xfer_data;
+	struct touch_xfer_data *d;
+	int i;
+
+	/* header in the side area, payload in the pool */
+	for (i = 0; i < xfer->msg_count; i++) {
+		d = &xfer->data[i];
+
+		if (d->rx.size) {
+			siw_emul_do_read(ts, siw_emul_hdr_addr(d->hdr),
+					d->rx.data, d->rx.size);
+			continue;
+		}
+
+		siw_emul_do_write(ts, siw_emul_hdr_addr(d->hdr),
+				d->tx.data, d->tx.size);
+	}
+
+	return 0;
+}
+
+/*
+ * Fills the register file directly (bypassing the bus)
+ */
+int siw_touch_emul_load(struct device *dev, u32 addr, void *data, int size)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+	struct siw_touch_emul *emul = ts->emul;
+
+	if (!emul) {
+		return -ENODEV;
+	}
+
+	siw_emul_copy(emul->reg, SIW_EMUL_REG_SIZE,
+			addr, (u8 *)data, size, 0);
+
+	return size;
+}
+
+/*
+ * Runs one recorded frame as an interrupt
+ */
+static int siw_touch_emul_do_frame(struct siw_ts *ts,
+				struct siw_touch_emul_rec *rec)
+{
+	struct device *dev = ts->dev;
+	struct siw_hal_reg *reg = siw_ops_reg(ts);
+
+	siw_touch_emul_load(dev, reg->tc_ic_status,
+			&rec->info, sizeof(rec->info));
+
+	return siw_touch_emul_irq(ts);
+}
+
+/*
+ * rate : 0 (free-running), 1 ~ SIW_EMUL_RATE_MAX (Hz),
+ *        -1 (recorded timestamps, limited to SIW_EMUL_RATE_MAX)
+ */
+static int siw_touch_emul_replay(struct device *dev, int rate)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+	struct siw_touch_emul *emul = ts->emul;
+	struct siw_touch_emul_result *result;
+	struct siw_touch_emul_rec *rec;
+	ktime_t start, t_frm, t_end;
+	s64 due_us = 0;
+	s64 now_us;
+	u64 cost;
+	u32 abs_evt;
+	u32 ts_base;
+	int count;
+	int i;
+
+	if (!emul) {
+		t_dev_err(dev, "bus emulation is off\n");
+		return -ENODEV;
+	}
+
+	count = emul->trace_size / sizeof(*rec);
+	if (!count) {
+		t_dev_err(dev, "no trace loaded\n");
+		return -ENOENT;
+	}
+
+	if (rate > SIW_EMUL_RATE_MAX) {
+		rate = SIW_EMUL_RATE_MAX;
+	}
+
+	result = &emul->result;
+	memset(result, 0, sizeof(*result));
+	result->rate = rate;
+
+	rec = (struct siw_touch_emul_rec *)emul->trace;
+	ts_base = rec->ts_us;
+	abs_evt = ts->abs_evt_cnt;
+
+	start = ktime_get();
+	for (i = 0; i < count; i++, rec++) {
+		if (rate) {
+			if (rate < 0) {
+				if (i)
+					due_us = max_t(s64,
+						due_us + (USEC_PER_SEC / SIW_EMUL_RATE_MAX),
+						(s64)(rec->ts_us - ts_base));
+			} else {
+				due_us = div_s64((s64)i * USEC_PER_SEC, rate);
+			}
+			now_us = ktime_us_delta(ktime_get(), start);
+			if (due_us > now_us) {
+				usleep_range(due_us - now_us, due_us - now_us + 50);
+			}
+		}
+
+		t_frm = ktime_get();
+		if (siw_touch_emul_do_frame(ts, rec) < 0) {
+			result->errors++;
+		}
+		cost = ktime_to_ns(ktime_sub(ktime_get(), t_frm));
+
+		result->cost_ns += cost;
+		if (cost > result->cost_max_ns)
+			result->cost_max_ns = cost;
+		result->frames++;
+	}
+	/* what the reporter has left */
+	siw_touch_report_flush(ts);
+	t_end = ktime_get();
+
+	result->elapsed_ns = ktime_to_ns(ktime_sub(t_end, start));
+	result->abs_evt = ts->abs_evt_cnt - abs_evt;
+
+	siw_touch_report_all_event(ts);
+
+	t_dev_info(dev, "replay: %d frames, %lld ns, %d abs events\n",
+		result->frames, (long long)result->elapsed_ns, result->abs_evt);
+
+	return 0;
+}
+
+static void siw_touch_emul_release(struct siw_touch_emul *emul)
+{
+	if (emul) {
+		vfree(emul->trace);
+		vfree(emul->sram);
+		vfree(emul->reg);
+		kfree(emul);
+	}
+}
+
+static int siw_touch_emul_on(struct device *dev)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_touch_emul *emul = NULL;
+
+	if (ts->emul) {
+		return 0;
+	}
+
+	emul = kzalloc(sizeof(*emul), GFP_KERNEL);
+	if (!emul) {
+		goto out;
+	}
+	emul->reg = vzalloc(SIW_EMUL_REG_SIZE);
+	emul->sram = vzalloc(SIW_EMUL_SRAM_SIZE);
+	if (!emul->reg || !emul->sram) {
+		goto out;
+	}
+	emul->dev = dev;
+
+	siw_touch_irq_control(dev, INTERRUPT_DISABLE);
+	siw_touch_mon_pause(dev);
+
+	mutex_lock(&ts->lock);
+	mutex_lock(&chip->bus_lock);
+
+	emul->bus_read = ts->bus_read;
+	emul->bus_write = ts->bus_write;
+	emul->bus_xfer = ts->bus_xfer;
+
+	ts->bus_read = siw_emul_bus_read;
+	ts->bus_write = siw_emul_bus_write;
+	ts->bus_xfer = siw_emul_bus_xfer;
+
+	ts->emul = emul;
+
+	mutex_unlock(&chip->bus_lock);
+	mutex_unlock(&ts->lock);
+
+	t_dev_info(dev, "bus emulation on\n");
+
+	return 0;
+
+out:
+	t_dev_err(dev, "failed to allocate bus emulation\n");
+	siw_touch_emul_release(emul);
+	return -ENOMEM;
+}
+
+static int siw_touch_emul_off(struct device *dev)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_touch_emul *emul = ts->emul;
+
+	if (!emul) {
+		return 0;
+	}
+
+	mutex_lock(&ts->lock);
+	mutex_lock(&chip->bus_lock);
+
+	ts->bus_read = emul->bus_read;
+	ts->bus_write = emul->bus_write;
+	ts->bus_xfer = emul->bus_xfer;
+
+	ts->emul = NULL;
+
+	mutex_unlock(&chip->bus_lock);
+	mutex_unlock(&ts->lock);
+
+	siw_touch_report_all_event(ts);
+
+	siw_touch_mon_resume(dev);
+	siw_touch_irq_control(dev, INTERRUPT_ENABLE);
+
+	t_dev_info(dev, "bus emulation off (rd %d/%lld, wr %d/%lld)\n",
+		emul->rd_cnt, (long long)emul->rd_bytes,
+		emul->wr_cnt, (long long)emul->wr_bytes);
+
+	siw_touch_emul_release(emul);
+
+	return 0;
+}
+
+static ssize_t _show_bus_emul(struct device *dev, char *buf)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+	struct siw_touch_emul *emul = NULL;
+	int size = 0;
+
+	mutex_lock(&siw_emul_lock);
+
+	emul = ts->emul;
+
+	size += siw_snprintf(buf, size, "bus emulation : %s\n",
+				(emul) ? "on" : "off");
+	if (emul) {
+		size += siw_snprintf(buf, size, " read  : %d, %lld bytes\n",
+					emul->rd_cnt, (long long)emul->rd_bytes);
+		size += siw_snprintf(buf, size, " write : %d, %lld bytes\n",
+					emul->wr_cnt, (long long)emul->wr_bytes);
+	}
+
+	size += siw_snprintf(buf, size, "\nUsage\n");
+	size += siw_snprintf(buf, size, " on/off    : echo {1|0} > bus_emul\n");
+	size += siw_snprintf(buf, size, " reg write : echo {addr} {value} > bus_emul\n");
+	size += siw_snprintf(buf, size, " trace     : cat {trace} > emul_trace\n");
+	size += siw_snprintf(buf, size, " replay    : echo {rate} > emul_replay\n");
+
+	mutex_unlock(&siw_emul_lock);
+
+	return (ssize_t)size;
+}
+
+static ssize_t _store_bus_emul(struct device *dev,
+				const char *buf, size_t count)
+{
+	u32 addr = 0;
+	u32 value = 0;
+	int ret = 0;
+
+	ret = sscanf(buf, "%X %X", &addr, &value);
+	if (ret <= 0) {
+		t_dev_err(dev, "Invalid param\n");
+		return count;
+	}
+
+	mutex_lock(&siw_emul_lock);
+
+	if (ret == 2) {
+		if (siw_touch_emul_load(dev, addr, &value, sizeof(value)) < 0)
+			t_dev_err(dev, "bus emulation is off\n");
+	} else if (addr) {
+		siw_touch_emul_on(dev);
+	} else {
+		siw_touch_emul_off(dev);
+	}
+
+	mutex_unlock(&siw_emul_lock);
+
+	return count;
+}
+
+static ssize_t _show_emul_replay(struct device *dev, char *buf)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+	struct siw_touch_emul *emul = NULL;
+	struct siw_touch_emul_result *result;
+	u64 fps = 0;
+	u64 avg = 0;
+	int size = 0;
+
+	mutex_lock(&siw_emul_lock);
+
+	emul = ts->emul;
+	if (!emul) {
+		size += siw_snprintf(buf, size, "bus emulation : off\n");
+		goto out;
+	}
+
+	result = &emul->result;
+
+	size += siw_snprintf(buf, size, "trace   : %d frames\n",
+				(int)(emul->trace_size / sizeof(struct siw_touch_emul_rec)));
+	if (!result->frames) {
+		goto out;
+	}
+
+	if (result->elapsed_ns)
+		fps = div64_u64((u64)result->frames * NSEC_PER_SEC, result->elapsed_ns);
+	avg = div_u64(result->cost_ns, result->frames);
+
+	size += siw_snprintf(buf, size, "rate    : %d\n", result->rate);
+	size += siw_snprintf(buf, size, "frames  : %d (err %d)\n",
+				result->frames, result->errors);
+	size += siw_snprintf(buf, size, "elapsed : %lld ns, %lld frames/s\n",
+				(long long)result->elapsed_ns, (long long)fps);
+	size += siw_snprintf(buf, size, "cost    : avg %lld ns, max %lld ns\n",
+				(long long)avg, (long long)result->cost_max_ns);
+	size += siw_snprintf(buf, size, "abs evt : %d (%d.%02d/frame)\n",
+				result->abs_evt,
+				result->abs_evt / result->frames,
+				((result->abs_evt % result->frames) * 100) / result->frames);
+
+out:
+	mutex_unlock(&siw_emul_lock);
+
+	return (ssize_t)size;
+}
+
+static ssize_t _store_emul_replay(struct device *dev,
+				const char *buf, size_t count)
+{
+	int rate = 0;
+
+	if (sscanf(buf, "%d", &rate) <= 0) {
+		t_dev_err(dev, "Invalid param\n");
+		return count;
+	}
+
+	mutex_lock(&siw_emul_lock);
+	siw_touch_emul_replay(dev, rate);
+	mutex_unlock(&siw_emul_lock);
+
+	return count;
+}
+
+static TOUCH_ATTR(bus_emul, _show_bus_emul, _store_bus_emul);
+static TOUCH_ATTR(emul_replay, _show_emul_replay, _store_emul_replay);
+
+static struct attribute *siw_touch_emul_attribute_list[] = {
+	&touch_attr_bus_emul.attr,
+	&touch_attr_emul_replay.attr,
+	NULL,
+};
+
+static const struct attribute_group siw_touch_emul_attribute_group = {
+	.attrs = siw_touch_emul_attribute_list,
+};
+
+/*
+ * Trace upload, a write at offset 0 starts a new trace
+ */
+static ssize_t siw_touch_emul_trace_write(struct file *filp, struct kobject *kobj,
+					struct bin_attribute *bin_attr,
+					char *buf, loff_t off, size_t count)
+{
+	struct siw_ts *ts = container_of(kobj, struct siw_ts, kobj);
+	struct device *dev = ts->dev;
+	struct siw_touch_emul *emul = NULL;
+	ssize_t ret = count;
+
+	mutex_lock(&siw_emul_lock);
+
+	emul = ts->emul;
+	if (!emul) {
+		t_dev_err(dev, "bus emulation is off\n");
+		ret = -ENODEV;
+		goto out;
+	}
+
+	if ((off + count) > SIW_EMUL_TRACE_MAX) {
+		t_dev_err(dev, "trace overflow: offset[%d] size[%d]\n",
+			(int)off, (int)count);
+		ret = -EOVERFLOW;
+		goto out;
+	}
+
+	if (!emul->trace) {
+		emul->trace = vmalloc(SIW_EMUL_TRACE_MAX);
+		if (!emul->trace) {
+			ret = -ENOMEM;
+			goto out;
+		}
+	}
+
+	if (!off) {
+		emul->trace_size = 0;
+		memset(&emul->result, 0, sizeof(emul->result));
+	}
+
+	memcpy(&emul->trace[off], buf, count);
+	emul->trace_size = max_t(int, emul->trace_size, off + count);
+
+out:
+	mutex_unlock(&siw_emul_lock);
+
+	return ret;
+}
+
+static struct bin_attribute siw_touch_emul_trace_attr = {
+	.attr = {
+		.name = "emul_trace",
+		.mode = S_IWUSR,
+	},
+	.size = SIW_EMUL_TRACE_MAX,
+	.write = siw_touch_emul_trace_write,
+};
+
+int siw_touch_emul_init(struct device *dev)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+	int ret = 0;
+
+	ret = sysfs_create_group(&ts->kobj, &siw_touch_emul_attribute_group);
+	if (ret < 0) {
+		t_dev_err(dev, "emul sysfs register failed, %d\n", ret);
+		return ret;
+	}
+
+	ret = sysfs_create_bin_file(&ts->kobj, &siw_touch_emul_trace_attr);
+	if (ret < 0) {
+		t_dev_err(dev, "failed to create %s, %d\n",
+			siw_touch_emul_trace_attr.attr.name, ret);
+		sysfs_remove_group(&ts->kobj, &siw_touch_emul_attribute_group);
+		return ret;
+	}
+
+	return 0;
+}
+
+void siw_touch_emul_free(struct device *dev)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+
+	mutex_lock(&siw_emul_lock);
+	siw_touch_emul_off(dev);
+	mutex_unlock(&siw_emul_lock);
+
+	sysfs_remove_bin_file(&ts->kobj, &siw_touch_emul_trace_attr);
+	sysfs_remove_group(&ts->kobj, &siw_touch_emul_attribute_group);
+}
+
+#endif	/* __SIW_SUPPORT_EMUL */
+
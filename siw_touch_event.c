@@ -39,60 +39,120 @@
 #include "siw_touch_event.h"
 
 
-#define __siw_input_report_abs(_idev, _code, _value)	\
+#define __siw_input_report_abs(_ts, _code, _value)	\
 	do {	\
 		if (t_dbg_flag & DBG_FLAG_SKIP_IEVENT) {	\
-			t_dev_dbg_event(&_idev->dev, "skip input report: c %d, v %d\n", _code, _value);	\
+			t_dev_dbg_event(&(_ts)->input->dev, "skip input report: c %d, v %d\n", _code, _value);	\
 		} else {	\
-			input_report_abs(_idev, _code, _value);	\
+			input_report_abs((_ts)->input, _code, _value);	\
+			(_ts)->abs_evt_cnt++;	\
 		}	\
 	} while (0)
 
-#define siw_input_report_abs(_idev, _code, _value)	\
+#define siw_input_report_abs(_ts, _code, _value)	\
 	do {	\
-		__siw_input_report_abs(_idev, _code, _value);	\
-		siwmon_submit_evt(&_idev->dev, "EV_ABS", EV_ABS, #_code, _code, _value, 0);	\
+		__siw_input_report_abs(_ts, _code, _value);	\
+		siwmon_submit_evt(&(_ts)->input->dev, "EV_ABS", EV_ABS, #_code, _code, _value, 0);	\
 	} while (0)
 
-static void siw_touch_report_palm_event(struct siw_ts *ts)
+static void siw_touch_report_palm_event(struct siw_ts *ts,
+				struct siw_touch_frame *frame)
 {
 	u16 old_mask = ts->old_mask;
 	int i = 0;
 
-	if (!ts->input)
-		return;
-
 	for (i = 0; i < touch_max_finger(ts); i++) {
 		if (old_mask & (1 << i)) {
 			input_mt_slot(ts->input, i);
-			siw_input_report_abs(ts->input,
+			siw_input_report_abs(ts,
 							ABS_MT_PRESSURE,
 							255);
+			ts->rpt_tdata[i].pressure = 255;
 			t_dev_info(&ts->input->dev, "finger canceled <%d> (%4d, %4d, %4d)\n",
 						i,
-						ts->tdata[i].x,
-						ts->tdata[i].y,
-						ts->tdata[i].pressure);
+						frame->tdata[i].x,
+						frame->tdata[i].y,
+						frame->tdata[i].pressure);
 		}
 	}
 
 	input_sync(ts->input);
 }
 
-void siw_touch_report_event(void *ts_data)
+#define __siw_touch_report_axis(_code, _field)	\
+	do {	\
+		if (force || (tdata->_field != last->_field)) {	\
+			if (!emitted)	\
+				input_mt_slot(ts->input, slot);	\
+			siw_input_report_abs(ts, _code, tdata->_field);	\
+			last->_field = tdata->_field;	\
+			emitted++;	\
+		}	\
+	} while (0)
+
+/*
+ * Reports the axes changed since the last report of the slot,
+ * returns the number of axes emitted
+ */
+static int siw_touch_report_slot(struct siw_ts *ts, int slot,
+				struct touch_data *tdata, int force)
 {
-	struct siw_ts *ts = ts_data;
+	struct touch_data *last = &ts->rpt_tdata[slot];
+	int emitted = 0;
+
+	__siw_touch_report_axis(ABS_MT_TRACKING_ID, id);
+	__siw_touch_report_axis(ABS_MT_POSITION_X, x);
+	__siw_touch_report_axis(ABS_MT_POSITION_Y, y);
+	__siw_touch_report_axis(ABS_MT_PRESSURE, pressure);
+	__siw_touch_report_axis(ABS_MT_WIDTH_MAJOR, width_major);
+	__siw_touch_report_axis(ABS_MT_WIDTH_MINOR, width_minor);
+	__siw_touch_report_axis(ABS_MT_ORIENTATION, orientation);
+
+	return emitted;
+}
+
+#undef __siw_touch_report_axis
+
+#define SIW_TOUCH_REPORT_AXES	7
+
+#if defined(__SIW_SUPPORT_LAT_HIST)
+static inline void siw_touch_frame_lat_stamp(struct siw_touch_frame *frame,
+				int stage)
+{
+	frame->lat_stamp[stage] = ktime_get();
+	frame->lat_valid |= (1<<stage);
+}
+
+static inline void siw_touch_frame_lat_commit(struct siw_ts *ts,
+				struct siw_touch_frame *frame)
+{
+	__siw_touch_lat_commit(ts, frame->lat_stamp, frame->lat_valid);
+}
+#else
+static inline void siw_touch_frame_lat_stamp(struct siw_touch_frame *frame,
+				int stage){ }
+static inline void siw_touch_frame_lat_commit(struct siw_ts *ts,
+				struct siw_touch_frame *frame){ }
+#endif
+
+static void siw_touch_report_frame(struct siw_ts *ts,
+				struct siw_touch_frame *frame)
+{
+	struct siw_touch_report_stat *stat = &ts->rpt_stat;
 	struct device *idev = &ts->input->dev;
+	struct touch_data *tdata = frame->tdata;
 	u16 old_mask = ts->old_mask;
-	u16 new_mask = ts->new_mask;
+	u16 new_mask = frame->new_mask;
 	u16 press_mask = 0;
 	u16 release_mask = 0;
 	u16 change_mask = 0;
+	int emitted = 0;
+	int cnt;
 	int i;
 
 //	t_dev_trcf(idev);
 
-	if (!ts->input)
+	if ((frame->flags & SIW_TOUCH_FRAME_RELEASE_ALL) && !old_mask)
 		return;
 
 	change_mask = old_mask ^ new_mask;
@@ -107,64 +167,187 @@ void siw_touch_report_event(void *ts_data)
 			change_mask, press_mask, release_mask);
 
 	/* Palm state - Report Pressure value 255 */
-	if (ts->is_palm) {
-		siw_touch_report_palm_event(ts);
-		ts->is_palm = 0;
+	if (frame->is_palm) {
+		siw_touch_report_palm_event(ts, frame);
 	}
 
 	for (i = 0; i < touch_max_finger(ts); i++) {
 		if (new_mask & (1 << i)) {
-			input_mt_slot(ts->input, i);
-			siw_input_report_abs(ts->input, ABS_MT_TRACKING_ID,
-						ts->tdata[i].id);
-			siw_input_report_abs(ts->input, ABS_MT_POSITION_X,
-						ts->tdata[i].x);
-			siw_input_report_abs(ts->input, ABS_MT_POSITION_Y,
-						ts->tdata[i].y);
-			siw_input_report_abs(ts->input, ABS_MT_PRESSURE,
-						ts->tdata[i].pressure);
-			siw_input_report_abs(ts->input, ABS_MT_WIDTH_MAJOR,
-						ts->tdata[i].width_major);
-			siw_input_report_abs(ts->input, ABS_MT_WIDTH_MINOR,
-						ts->tdata[i].width_minor);
-			siw_input_report_abs(ts->input, ABS_MT_ORIENTATION,
-						ts->tdata[i].orientation);
+			/* new contact : all axes, otherwise only the changed */
+			cnt = siw_touch_report_slot(ts, i, &tdata[i],
+						!!(press_mask & (1 << i)));
+			emitted += cnt;
+			stat->emitted += cnt;
+			stat->suppressed += (SIW_TOUCH_REPORT_AXES - cnt);
 
 			if (press_mask & (1 << i)) {
 				t_dev_dbg_abs(idev, "%d finger press <%d> (%4d, %4d, %4d)\n",
-						ts->tcount,
+						frame->tcount,
 						i,
-						ts->tdata[i].x,
-						ts->tdata[i].y,
-						ts->tdata[i].pressure);
+						tdata[i].x,
+						tdata[i].y,
+						tdata[i].pressure);
 			}
 		} else if (release_mask & (1 << i)) {
 			input_mt_slot(ts->input, i);
-			siw_input_report_abs(ts->input, ABS_MT_TRACKING_ID, -1);
+			siw_input_report_abs(ts, ABS_MT_TRACKING_ID, -1);
+			memset(&ts->rpt_tdata[i], 0, sizeof(struct touch_data));
+			stat->emitted++;
 			t_dev_dbg_abs(idev, "finger release <%d> (%4d, %4d, %4d)\n",
 					i,
-					ts->tdata[i].x,
-					ts->tdata[i].y,
-					ts->tdata[i].pressure);
+					tdata[i].x,
+					tdata[i].y,
+					tdata[i].pressure);
 		}
 	}
 
 	ts->old_mask = new_mask;
 
+	/* nothing moved : no event, no sync */
+	if (!emitted && !change_mask && !frame->is_palm) {
+		stat->dropped++;
+		return;
+	}
+
 	input_sync(ts->input);
+	stat->frames++;
+
+	if (!(frame->flags & SIW_TOUCH_FRAME_RELEASE_ALL))
+		siw_touch_frame_lat_stamp(frame, SIW_LAT_REPORT);
+}
+
+/*
+ * Producer side of the frame ring, ts->lock shall be held
+ */
+static int siw_touch_frame_push(struct siw_ts *ts, int flags)
+{
+	struct siw_touch_frame_ring *ring = &ts->fring;
+	struct siw_touch_frame *frame;
+	unsigned int head = ring->head;
+	unsigned int tail = READ_ONCE(ring->tail);
+
+	if ((head - tail) >= SIW_TOUCH_FRAME_RING_SZ) {
+		ring->overrun++;
+		return -ENOSPC;
+	}
+
+	frame = &ring->frame[head & (SIW_TOUCH_FRAME_RING_SZ - 1)];
+	frame->new_mask = ts->new_mask;
+	frame->tcount = ts->tcount;
+	frame->is_palm = !!ts->is_palm;
+	frame->flags = flags;
+	memcpy(frame->tdata, ts->tdata, sizeof(frame->tdata));
+
+#if defined(__SIW_SUPPORT_LAT_HIST)
+	/* the stamps of this irq go with the frame, see siw_touch_lat_commit */
+	frame->lat_valid = 0;
+	if (!(flags & SIW_TOUCH_FRAME_RELEASE_ALL)) {
+		memcpy(frame->lat_stamp, ts->lat.stamp, sizeof(frame->lat_stamp));
+		frame->lat_valid = ts->lat.valid;
+		ts->lat.valid = 0;
+	}
+#endif
+
+	/* publish the frame before the index */
+	smp_wmb();
+	WRITE_ONCE(ring->head, head + 1);
+
+	if (ts->report_wq)
+		queue_work(ts->report_wq, &ts->report_work);
+
+	return 0;
+}
+
+/*
+ * Consumer side of the frame ring (ts->report_wq, high priority, ordered)
+ * The only one draining it, without ts->lock or any other lock,
+ * so a slow ts->lock holder doesn't delay input delivery.
+ */
+void siw_touch_report_work_func(struct work_struct *work)
+{
+	struct siw_ts *ts = container_of(work, struct siw_ts, report_work);
+	struct siw_touch_frame_ring *ring = &ts->fring;
+	struct siw_touch_frame *frame;
+	unsigned int head;
+	unsigned int tail;
+
+	if (READ_ONCE(ts->rpt_stat_clr)) {
+		memset(&ts->rpt_stat, 0, sizeof(ts->rpt_stat));
+		WRITE_ONCE(ts->rpt_stat_clr, 0);
+	}
+
+	while (1) {
+		head = READ_ONCE(ring->head);
+		tail = ring->tail;
+		if (tail == head)
+			break;
+
+		/* read the frame after the index */
+		smp_rmb();
+
+		frame = &ring->frame[tail & (SIW_TOUCH_FRAME_RING_SZ - 1)];
+		if (ts->input)
+			siw_touch_report_frame(ts, frame);
+		siw_touch_frame_lat_commit(ts, frame);
+
+		/* release the slot after reading it */
+		smp_mb();
+		WRITE_ONCE(ring->tail, tail + 1);
+	}
+}
+
+/*
+ * Waits until the reporter has drained what is queued so far,
+ * not to be called from the reporter itself
+ */
+void siw_touch_report_flush(void *ts_data)
+{
+	struct siw_ts *ts = ts_data;
+
+	if (!ts->report_wq)
+		return;
+
+	queue_work(ts->report_wq, &ts->report_work);
+	flush_work(&ts->report_work);
+}
+
+static void siw_touch_report_push(struct siw_ts *ts, int flags)
+{
+	if (siw_touch_frame_push(ts, flags) < 0) {
+		/*
+		 * reporter is behind by a whole ring, wait for it and retry
+		 * (it never takes ts->lock)
+		 */
+		siw_touch_report_flush(ts);
+		siw_touch_frame_push(ts, flags);
+	}
+}
+
+/*
+ * Queues the current decoded frame for the reporter
+ */
+void siw_touch_report_event(void *ts_data)
+{
+	struct siw_ts *ts = ts_data;
+
+	siw_touch_report_push(ts, 0);
+
+	/* palm cancel is one-shot */
+	ts->is_palm = 0;
 }
 
 void siw_touch_report_all_event(void *ts_data)
 {
 	struct siw_ts *ts = ts_data;
+
 	ts->is_palm = 1;
-	if (ts->old_mask) {
-		ts->new_mask = 0;
-		siw_touch_report_event(ts);
-		ts->tcount = 0;
-		memset(ts->tdata, 0, sizeof(struct touch_data) * touch_max_finger(ts));
-	}
+	ts->new_mask = 0;
+	siw_touch_report_push(ts, SIW_TOUCH_FRAME_RELEASE_ALL);
+	ts->tcount = 0;
+	memset(ts->tdata, 0, sizeof(struct touch_data) * touch_max_finger(ts));
 	ts->is_palm = 0;
+
+	siw_touch_report_flush(ts);
 }
 
 #if defined(__SIW_SUPPORT_UEVENT)
@@ -457,6 +640,9 @@ void siw_touch_free_input(void *ts_data)
 
 		ts->input = NULL;
 
+		/* the reporter may still hold the input device */
+		cancel_work_sync(&ts->report_work);
+
 		t_dev_info(&input->dev, "input device[%s] released\n",
 					input->phys);
 
@@ -13,6 +13,8 @@
 #define __SIW_TOUCH_EVENT_H
 
 extern void siw_touch_report_event(void *ts_data);
+extern void siw_touch_report_flush(void *ts_data);
+extern void siw_touch_report_work_func(struct work_struct *work);
 extern void siw_touch_report_all_event(void *ts_data);
 extern void siw_touch_send_uevent(void *ts_data, int type);
 
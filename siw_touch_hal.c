@@ -30,6 +30,7 @@
 #include <linux/of_gpio.h>
 #include <linux/of_device.h>
 #include <linux/firmware.h>
+#include <linux/crc32.h>
 #include <asm/page.h>
 #include <asm/uaccess.h>
 #include <asm/irq.h>
@@ -48,7 +49,42 @@
 #define __weak __attribute__((weak))
 #endif
 
-//#define __FW_VERIFY_TEST
+/*
+ * 0 : no verify
+ * 1 : code SRAM read-back compare after download
+ * 2 : compare only when the code window bursts over 1K (default)
+ */
+static u32 t_fw_verify = 2;
+
+/* usage
+ * (1) echo <value> > /sys/module/{Siw Touch Module Name}/parameters/fw_verify
+ * (2) insmod {Siw Touch Module Name}.ko fw_verify=<value>
+ */
+module_param_named(fw_verify, t_fw_verify, uint, S_IRUGO|S_IWUSR|S_IWGRP);
+
+/*
+ * 0 : full code and conf download always
+ * 1 : skip the blocks unchanged since the last upgrade (block CRC manifest)
+ */
+static u32 t_fw_delta = 1;
+
+/* usage
+ * (1) echo <value> > /sys/module/{Siw Touch Module Name}/parameters/fw_delta
+ * (2) insmod {Siw Touch Module Name}.ko fw_delta=<value>
+ */
+module_param_named(fw_delta, t_fw_delta, uint, S_IRUGO|S_IWUSR|S_IWGRP);
+
+/*
+ * 0 : F/W image released after each upgrade
+ * 1 : F/W image and its parsed info kept until the file changes
+ */
+static u32 t_fw_cache = 1;
+
+/* usage
+ * (1) echo <value> > /sys/module/{Siw Touch Module Name}/parameters/fw_cache
+ * (2) insmod {Siw Touch Module Name}.ko fw_cache=<value>
+ */
+module_param_named(fw_cache, t_fw_cache, uint, S_IRUGO|S_IWUSR|S_IWGRP);
 
 enum {
 	LPWG_SET_SKIP = -1,
@@ -377,7 +413,13 @@ static void *__siw_hal_get_curr_buf(struct siw_ts *ts, dma_addr_t *dma, int tx)
 	return buf;
 }
 
-static int __used __siw_hal_do_reg_read(struct device *dev, u32 addr, void *data, int size)
+/*
+ * Builds the read header into tx_buf and runs the bus read
+ * Returns the offset of the payload in rx_buf
+ */
+static int __siw_hal_do_reg_read_buf(struct device *dev, u32 addr, int size,
+				u8 *tx_buf, dma_addr_t tx_dma,
+				u8 *rx_buf, dma_addr_t rx_dma)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
 	struct siw_ts *ts = chip->ts;
@@ -390,23 +432,8 @@ static int __used __siw_hal_do_reg_read(struct device *dev, u32 addr, void *data
 	struct touch_bus_msg _msg = {0, };
 	struct touch_bus_msg *msg = &_msg;
 	int tx_size = bus_tx_hdr_size;
-	u8 *tx_buf;
-	u8 *rx_buf;
-	dma_addr_t tx_dma;
-	dma_addr_t rx_dma;
 	int ret = 0;
 
-#if 0
-	if (!addr) {
-		t_dev_err(dev, "NULL addr\n");
-		return -EFAULT;
-	}
-#endif
-	if (!data) {
-		t_dev_err(dev, "NULL data\n");
-		return -EFAULT;
-	}
-
 #if defined(__SIW_I2C_TYPE_1)
 	if (touch_bus_type(ts) == BUS_IF_I2C) {
 		struct siw_hal_reg *reg = chip->reg;
@@ -453,9 +480,6 @@ static int __used __siw_hal_do_reg_read(struct device *dev, u32 addr, void *data
 
 //	t_dev_info(dev, "addr %04Xh, size %d\n", addr, size);
 
-	tx_buf = __siw_hal_get_curr_buf(ts, &tx_dma, 1);
-	rx_buf = __siw_hal_get_curr_buf(ts, &rx_dma, 0);
-
 	tx_buf[0] = bus_rd_hdr_flag | ((size > 4) ? 0x20 : 0x00);
 	tx_buf[0] |= ((addr >> 8) & 0x0f);
 	tx_buf[1] = (addr & 0xff);
@@ -480,7 +504,40 @@ static int __used __siw_hal_do_reg_read(struct device *dev, u32 addr, void *data
 		return ret;
 	}
 
-	memcpy(data, &rx_buf[bus_rx_hdr_size], size);
+	return bus_rx_hdr_size;
+}
+
+static int __used __siw_hal_do_reg_read(struct device *dev, u32 addr, void *data, int size)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	u8 *tx_buf;
+	u8 *rx_buf;
+	dma_addr_t tx_dma;
+	dma_addr_t rx_dma;
+	int ret = 0;
+
+#if 0
+	if (!addr) {
+		t_dev_err(dev, "NULL addr\n");
+		return -EFAULT;
+	}
+#endif
+	if (!data) {
+		t_dev_err(dev, "NULL data\n");
+		return -EFAULT;
+	}
+
+	tx_buf = __siw_hal_get_curr_buf(ts, &tx_dma, 1);
+	rx_buf = __siw_hal_get_curr_buf(ts, &rx_dma, 0);
+
+	ret = __siw_hal_do_reg_read_buf(dev, addr, size,
+				tx_buf, tx_dma, rx_buf, rx_dma);
+	if (ret < 0) {
+		return ret;
+	}
+
+	memcpy(data, &rx_buf[ret], size);
 
 	return size;
 }
@@ -608,19 +665,43 @@ static int __used __siw_hal_do_xfer_to_single(struct device *dev, struct touch_x
 	return 0;
 }
 
+/*
+ * rx header and dummy size of chained xfer
+ */
+static void __siw_hal_xfer_rx_cfg(struct siw_ts *ts,
+				int *rx_hdr_size, int *rx_dummy_size)
+{
+	int bus_rx_hdr_size = touch_rx_hdr_size(ts);
+	int bus_rx_dummy_size = (touch_rx_dummy_size(ts) & 0xFFFF);
+#if defined(__SIW_SPI_TYPE_1)
+	int bus_rx_dummy_flag = (touch_rx_dummy_size(ts) >> 16);
+
+	/*
+	 * 0x10 : 128-bit dummy
+	 * size > 4 : burst
+	 */
+	if (bus_rx_dummy_flag & SPI_BUS_RX_DUMMY_FLAG_128BIT) {
+		bus_rx_hdr_size = SPI_BUS_RX_HDR_SZ_32BIT;
+		bus_rx_dummy_size = SPI_BUS_RX_DUMMY_SZ_32BIT;
+	}
+#endif
+
+	*rx_hdr_size = bus_rx_hdr_size;
+	*rx_dummy_size = bus_rx_dummy_size;
+}
+
 static int __used __siw_hal_do_xfer_msg(struct device *dev, struct touch_xfer_msg *xfer)
 {
 	struct siw_ts *ts = to_touch_core(dev);
+	struct touch_xfer_data *d = NULL;
 	struct touch_xfer_data_t *tx = NULL;
 	struct touch_xfer_data_t *rx = NULL;
 	int bus_tx_hdr_size = touch_tx_hdr_size(ts);
-	int bus_rx_hdr_size = touch_rx_hdr_size(ts);
+	int bus_rx_hdr_size = 0;
 //	int bus_tx_dummy_size = touch_tx_dummy_size(ts);
-	int bus_rx_dummy_size = (touch_rx_dummy_size(ts) & 0xFFFF);
-	int bus_rx_dummy_flag = (touch_rx_dummy_size(ts) >> 16);
+	int bus_rx_dummy_size = 0;
 	int bus_dummy;
-	int buf_size = touch_get_act_buf_size(ts);
-	int tx_size;
+	int hdr_size;
 	int i = 0;
 	int ret = 0;
 
@@ -630,22 +711,14 @@ static int __used __siw_hal_do_xfer_msg(struct device *dev, struct touch_xfer_ms
 
 	t_dev_dbg_base(dev, "xfer: start\n");
 
-#if defined(__SIW_SPI_TYPE_1)
-	/*
-	 * 0x10 : 128-bit dummy
-	 * size > 4 : burst
-	 */
-	if (bus_rx_dummy_flag & SPI_BUS_RX_DUMMY_FLAG_128BIT) {
-		bus_rx_hdr_size = SPI_BUS_RX_HDR_SZ_32BIT;
-		bus_rx_dummy_size = SPI_BUS_RX_DUMMY_SZ_32BIT;
-	}
-#else
-	bus_rx_dummy_flag = 0;
-#endif
+	__siw_hal_xfer_rx_cfg(ts, &bus_rx_hdr_size, &bus_rx_dummy_size);
+
+	xfer->pool_used = 0;
 
 	for (i = 0; i < xfer->msg_count; i++) {
-		tx = &xfer->data[i].tx;
-		rx = &xfer->data[i].rx;
+		d = &xfer->data[i];
+		tx = &d->tx;
+		rx = &d->rx;
 
 		if (rx->size) {
 			t_dev_dbg_base(dev, "xfer: rd set(%d)\n", i);
@@ -656,17 +729,23 @@ static int __used __siw_hal_do_xfer_msg(struct device *dev, struct touch_xfer_ms
 				return -EFAULT;
 			}
 		#endif
-			tx_size = bus_tx_hdr_size;
+			hdr_size = bus_tx_hdr_size;
 			bus_dummy = bus_rx_dummy_size;
 
-			tx->data[0] = (rx->size > 4) ? 0x20 : 0x00;
-			tx->data[0] |= ((rx->addr >> 8) & 0x0f);
-			tx->data[1] = (rx->addr & 0xff);
+			d->hdr[0] = (rx->size > 4) ? 0x20 : 0x00;
+			d->hdr[0] |= ((rx->addr >> 8) & 0x0f);
+			d->hdr[1] = (rx->addr & 0xff);
 			while (bus_dummy--) {
-				tx->data[tx_size++] = 0;
+				d->hdr[hdr_size++] = 0;
+			}
+			d->hdr_size = hdr_size;
+			tx->size = 0;
+
+			rx->data = touch_xfer_pool_get(xfer, rx->size);
+			if (!rx->data) {
+				t_dev_err(dev, "buffer overflow\n");
+				return -EOVERFLOW;
 			}
-			tx->size = tx_size;
-			rx->size += bus_rx_hdr_size;
 			continue;
 		}
 
@@ -680,17 +759,18 @@ static int __used __siw_hal_do_xfer_msg(struct device *dev, struct touch_xfer_ms
 		}
 	#endif
 
-		if (tx->size > (buf_size - bus_tx_hdr_size)) {
+		tx->data = touch_xfer_pool_get(xfer, tx->size);
+		if (!tx->data) {
 			t_dev_err(dev, "buffer overflow\n");
 			return -EOVERFLOW;
 		}
 
-	//	tx->data[0] = ((tx->size == 1) ? 0x60 : 0x40);
-		tx->data[0] = 0x60;
-		tx->data[0] |= ((tx->addr >> 8) & 0x0f);
-		tx->data[1] = (tx->addr  & 0xff);
-		memcpy(&tx->data[bus_tx_hdr_size], tx->buf, tx->size);
-		tx->size += bus_tx_hdr_size;
+	//	d->hdr[0] = ((tx->size == 1) ? 0x60 : 0x40);
+		d->hdr[0] = 0x60;
+		d->hdr[0] |= ((tx->addr >> 8) & 0x0f);
+		d->hdr[1] = (tx->addr  & 0xff);
+		d->hdr_size = bus_tx_hdr_size;
+		memcpy(tx->data, tx->buf, tx->size);
 	}
 
 	t_dev_dbg_base(dev, "xfer: call bus xfer\n");
@@ -711,8 +791,7 @@ static int __used __siw_hal_do_xfer_msg(struct device *dev, struct touch_xfer_ms
 				t_dev_err(dev, "NULL xfer->data[%d].rx.buf\n", i);
 				return -EFAULT;
 			}
-			memcpy(rx->buf, rx->data + bus_rx_hdr_size,
-				(rx->size - bus_rx_hdr_size));
+			memcpy(rx->buf, rx->data, rx->size);
 		}
 		ret += rx->size;
 	}
@@ -747,6 +826,43 @@ int siw_hal_reg_read(struct device *dev, u32 addr, void *data, int size)
 	return ret;
 }
 
+/*
+ * Zero-copy read for the irq thread
+ * The payload stays in the dedicated irq rx slot and
+ * (*data) points to it until the next irq read
+ */
+static int siw_hal_reg_read_irq(struct device *dev, u32 addr, void **data, int size)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	struct siw_touch_buf *tx = &ts->tx_buf_irq;
+	struct siw_touch_buf *rx = &ts->rx_buf_irq;
+	int ret = 0;
+
+	if (!tx->buf || !rx->buf) {
+		return -ENOMEM;
+	}
+
+	if ((size + SPI_BUS_RX_HDR_SZ_128BIT) > rx->size) {
+		t_dev_err(dev, "irq read size overflow, %d\n", size);
+		return -EOVERFLOW;
+	}
+
+	mutex_lock(&chip->bus_lock);
+	ret = __siw_hal_do_reg_read_buf(dev, addr, size,
+				tx->buf, tx->dma, rx->buf, rx->dma);
+	mutex_unlock(&chip->bus_lock);
+	if (ret < 0) {
+		t_hal_bus_err(dev, "read irq err[%03Xh, 0x%X], %d",
+				addr, size, ret);
+		return ret;
+	}
+
+	*data = &rx->buf[ret];
+
+	return size;
+}
+
 int siw_hal_reg_write(struct device *dev, u32 addr, void *data, int size)
 {
 	int ret = __siw_hal_reg_write(dev, addr, data, size);
@@ -823,6 +939,142 @@ void siw_hal_xfer_add_tx(void *xfer_data, u32 reg, void *buf, u32 size)
 	xfer->msg_count++;
 }
 
+void siw_hal_xfer_tmpl_init(struct device *dev, struct siw_hal_xfer_tmpl *tmpl)
+{
+	memset(tmpl, 0, sizeof(*tmpl));
+}
+
+int siw_hal_xfer_tmpl_add(struct device *dev, struct siw_hal_xfer_tmpl *tmpl,
+				u32 addr, int rd)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+	struct siw_hal_xfer_ent *ent = NULL;
+	int bus_tx_hdr_size = touch_tx_hdr_size(ts);
+	int bus_rx_hdr_size = 0;
+	int bus_rx_dummy_size = 0;
+	int hdr_size = bus_tx_hdr_size;
+
+	if (tmpl->cnt >= SIW_TOUCH_MAX_XFER_COUNT) {
+		t_dev_err(dev, "xfer tmpl overflow\n");
+		return -EOVERFLOW;
+	}
+
+	__siw_hal_xfer_rx_cfg(ts, &bus_rx_hdr_size, &bus_rx_dummy_size);
+
+	if (rd) {
+		hdr_size += bus_rx_dummy_size;
+	}
+
+	if (hdr_size > SIW_HAL_XFER_HDR_MAX) {
+		t_dev_err(dev, "xfer tmpl hdr overflow, %d\n", hdr_size);
+		return -EOVERFLOW;
+	}
+
+	ent = &tmpl->ent[tmpl->cnt];
+	memset(ent, 0, sizeof(*ent));
+
+	/* burst bit(0x20) of read is set per run */
+	ent->hdr[0] = (rd) ? 0x00 : 0x60;
+	ent->hdr[0] |= ((addr >> 8) & 0x0f);
+	ent->hdr[1] = (addr & 0xff);
+	ent->hdr_size = hdr_size;
+	ent->addr = addr;
+	ent->rd = !!rd;
+
+	tmpl->cnt++;
+
+	return 0;
+}
+
+/*
+ * Runs the first cnt entries of the template as one chained message,
+ * io[i] is the rx buffer (rd) or the tx payload (wr) of the entry
+ */
+int siw_hal_xfer_tmpl_run(struct device *dev, struct siw_hal_xfer_tmpl *tmpl,
+				struct siw_hal_xfer_io *io, int cnt)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	struct touch_xfer_msg *xfer = ts->xfer;
+	struct siw_hal_xfer_ent *ent = NULL;
+	struct touch_xfer_data *d = NULL;
+	struct touch_xfer_data_t *tx = NULL;
+	struct touch_xfer_data_t *rx = NULL;
+	u8 *data;
+	int i;
+	int ret = 0;
+
+	if (!xfer || !touch_xfer_allowed(ts) || (cnt > tmpl->cnt)) {
+		return -EINVAL;
+	}
+
+	mutex_lock(&chip->bus_lock);
+
+	xfer->bits_per_word = 8;
+	xfer->msg_count = cnt;
+	xfer->pool_used = 0;
+
+	for (i = 0; i < cnt; i++) {
+		ent = &tmpl->ent[i];
+		d = &xfer->data[i];
+		tx = &d->tx;
+		rx = &d->rx;
+
+		data = touch_xfer_pool_get(xfer, io[i].size);
+		if (!data) {
+			t_dev_err(dev, "xfer tmpl buffer overflow[%d], %d\n",
+				i, io[i].size);
+			ret = -EOVERFLOW;
+			goto out;
+		}
+
+		memcpy(d->hdr, ent->hdr, ent->hdr_size);
+		d->hdr_size = ent->hdr_size;
+
+		if (ent->rd) {
+			if (io[i].size > 4)
+				d->hdr[0] |= 0x20;
+			tx->addr = 0;
+			tx->size = 0;
+			rx->addr = ent->addr;
+			rx->buf = io[i].buf;
+			rx->data = data;
+			rx->size = io[i].size;
+			continue;
+		}
+
+		memcpy(data, io[i].buf, io[i].size);
+		tx->addr = ent->addr;
+		tx->data = data;
+		tx->size = io[i].size;
+		rx->addr = 0;
+		rx->buf = NULL;
+		rx->size = 0;
+	}
+
+	ret = siw_touch_bus_xfer(dev, xfer);
+	if (ret < 0) {
+		t_dev_err(dev, "touch bus xfer(tmpl) error, %d\n", ret);
+		__siw_hal_do_xfer_dbg(dev, xfer);
+		goto out;
+	}
+
+	ret = 0;
+	for (i = 0; i < cnt; i++) {
+		rx = &xfer->data[i].rx;
+
+		if (rx->size) {
+			memcpy(rx->buf, rx->data, rx->size);
+			ret += rx->size;
+		}
+	}
+
+out:
+	mutex_unlock(&chip->bus_lock);
+
+	return ret;
+}
+
 static int siw_hal_cmd_write(struct device *dev, u8 cmd)
 {
 //	struct siw_touch_chip *chip = to_touch_chip(dev);
@@ -918,11 +1170,13 @@ static void siw_hal_free_works(struct siw_touch_chip *chip)
 static void siw_hal_init_locks(struct siw_touch_chip *chip)
 {
 	mutex_init(&chip->bus_lock);
+	mutex_init(&chip->fwup_lock);
 }
 
 static void siw_hal_free_locks(struct siw_touch_chip *chip)
 {
 	mutex_destroy(&chip->bus_lock);
+	mutex_destroy(&chip->fwup_lock);
 }
 
 
@@ -1312,6 +1566,7 @@ static int siw_hal_do_ic_info(struct device *dev, int prt_on)
 
 	siw_hal_fw_set_chip_id(fw, chip_id);
 	siw_hal_fw_set_version(fw, version, version_ext);
+	siw_hal_fw_delta_sync(&chip->fw_delta, fw);
 	siw_hal_fw_set_revision(fw, revision);
 	siw_hal_fw_set_prod_id(fw, (u8 *)product, sizeof(product));
 
@@ -2000,16 +2255,120 @@ out:
 	return ret;
 }
 
+/*
+ * F/W code download
+ *
+ * The code window auto-increments from spr_code_offset, so a slice
+ * can be as large as the bus buffer allows.
+ * With xfer on SPI, offset+data pairs are chained in one message
+ * while they fit in the xfer pool.
+ * CHIP_QUIRK_NOT_SUPPORT_FW_BURST keeps the 1K slices and is set
+ * on every chip whose code window hasn't been confirmed to
+ * auto-increment over 1K.
+ */
+static int siw_hal_fw_dn_burst_size(struct device *dev)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	int size;
+
+	if (touch_test_quirks(ts, CHIP_QUIRK_NOT_SUPPORT_FW_BURST)) {
+		return MAX_RW_SIZE;
+	}
+
+	size = touch_get_act_buf_size(ts) - SIW_TOUCH_XFER_HDR_SZ;
+	if (touch_xfer_allowed(ts)) {
+		/* the offset word shares the xfer pool */
+		size = min_t(int, size,
+				ts->xfer->pool_size - L1_CACHE_ALIGN(sizeof(u32)));
+	}
+	size = rounddown(size, MAX_RW_SIZE);
+
+	return max_t(int, size, MAX_RW_SIZE);
+}
+
+static int siw_hal_fw_upgrade_fw_core_xfer(struct device *dev,
+				u8 *dn_buf, int dn_size, int burst)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	struct siw_hal_reg *reg = chip->reg;
+	struct touch_xfer_msg *xfer = ts->xfer;
+	u32 offset[SIW_TOUCH_MAX_XFER_COUNT>>1];
+	int fw_pos, curr_size;
+	int pool_used;
+	int need;
+	int cnt;
+	int sent;
+	int ret = 0;
+
+	fw_pos = 0;
+	while (fw_pos < dn_size) {
+		siw_hal_xfer_init(dev, xfer);
+
+		pool_used = 0;
+		sent = fw_pos;
+		cnt = 0;
+		while ((fw_pos < dn_size) && (cnt < ARRAY_SIZE(offset))) {
+			curr_size = min(dn_size - fw_pos, burst);
+			need = L1_CACHE_ALIGN(sizeof(u32)) + L1_CACHE_ALIGN(curr_size);
+			if (cnt && ((pool_used + need) > xfer->pool_size)) {
+				break;
+			}
+
+			offset[cnt] = fw_pos>>2;
+			siw_hal_xfer_add_tx(xfer, reg->spr_code_offset,
+					(void *)&offset[cnt], sizeof(u32));
+			siw_hal_xfer_add_tx(xfer, reg->code_access_addr,
+					(void *)&dn_buf[fw_pos], curr_size);
+
+			t_dev_dbg_base(dev, "FW upgrade: fw_pos[%06Xh ...] = %02X %02X %02X %02X ... (%d)\n",
+					fw_pos,
+					dn_buf[fw_pos], dn_buf[fw_pos + 1],
+					dn_buf[fw_pos + 2], dn_buf[fw_pos + 3],
+					curr_size);
+
+			pool_used += need;
+			fw_pos += curr_size;
+			cnt++;
+		}
+
+		ret = siw_hal_xfer_msg(dev, xfer);
+		if (ret < 0) {
+			t_dev_err(dev, "FW upgrade: xfer failed at %06Xh, %d\n",
+				fw_pos, ret);
+			goto out;
+		}
+
+		siw_touch_fwup_dn_done(ts, fw_pos - sent);
+	}
+
+out:
+	return ret;
+}
+
 static int siw_hal_fw_upgrade_fw_core(struct device *dev, u8 *dn_buf, int dn_size)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
-//	struct siw_ts *ts = chip->ts;
+	struct siw_ts *ts = chip->ts;
 	struct siw_hal_reg *reg = chip->reg;
 	u8 *fw_data;
 	int fw_size;
 	int fw_pos, curr_size;
+	int burst;
 	int ret = 0;
 
+	burst = siw_hal_fw_dn_burst_size(dev);
+
+	t_dev_info(dev, "FW upgrade: code dn %d bytes, burst %d%s\n",
+			dn_size, burst,
+			(touch_xfer_allowed(ts) &&
+			(touch_bus_type(ts) == BUS_IF_SPI)) ? ", xfer" : "");
+
+	if (touch_xfer_allowed(ts) && (touch_bus_type(ts) == BUS_IF_SPI)) {
+		return siw_hal_fw_upgrade_fw_core_xfer(dev, dn_buf, dn_size, burst);
+	}
+
 	fw_data = dn_buf;
 	fw_size = dn_size;
 	fw_pos = 0;
@@ -2018,7 +2377,7 @@ static int siw_hal_fw_upgrade_fw_core(struct device *dev, u8 *dn_buf, int dn_siz
 				fw_pos,
 				fw_data[0], fw_data[1], fw_data[2], fw_data[3]);
 
-		curr_size = min(fw_size, MAX_RW_SIZE);
+		curr_size = min(fw_size, burst);
 
 		/* code sram base address write */
 		ret = siw_hal_fw_wr_value(dev, reg->spr_code_offset, fw_pos>>2);
@@ -2032,6 +2391,8 @@ static int siw_hal_fw_upgrade_fw_core(struct device *dev, u8 *dn_buf, int dn_siz
 			goto out;
 		}
 
+		siw_touch_fwup_dn_done(ts, curr_size);
+
 		fw_data += curr_size;
 		fw_pos += curr_size;
 		fw_size -= curr_size;
@@ -2045,7 +2406,7 @@ static int siw_hal_fw_upgrade_conf_core(struct device *dev,
 				u32 addr, u8 *dn_buf, int dn_size)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
-//	struct siw_ts *ts = chip->ts;
+	struct siw_ts *ts = chip->ts;
 	struct siw_hal_reg *reg = chip->reg;
 	int ret;
 
@@ -2065,6 +2426,8 @@ static int siw_hal_fw_upgrade_conf_core(struct device *dev,
 		goto out;
 	}
 
+	siw_touch_fwup_dn_done(ts, dn_size);
+
 out:
 	return ret;
 }
@@ -2180,6 +2543,24 @@ out:
 	return ret;
 }
 
+static u32 siw_hal_fw_conf_crc_quirk(struct device *dev,
+			     u8 *fw_buf, u32 crc)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	u32 data;
+
+	if (!chip->fw.conf_index) {
+		return crc;
+	}
+
+	data = touch_fw_size(ts) +	\
+		(NUM_C_CONF<<POW_C_CONF) +	\
+		((chip->fw.conf_index - 1)<<POW_S_CONF);
+
+	return crc32_le(crc, &fw_buf[data], FLASH_CONF_SIZE);
+}
+
 static int siw_hal_fw_size_check(struct device *dev, int fw_size)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
@@ -2272,6 +2653,12 @@ static int siw_hal_fw_upgrade_conf_quirk(struct device *dev,
 	return 0;
 }
 
+static u32 siw_hal_fw_conf_crc_quirk(struct device *dev,
+			     u8 *fw_buf, u32 crc)
+{
+	return crc;
+}
+
 static int siw_hal_fw_size_check(struct device *dev, int fw_size)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
@@ -2300,24 +2687,108 @@ enum {
 	BIN_PID_OFFSET_POS = 0xF0,
 };
 
-static int siw_hal_fw_compare(struct device *dev, u8 *fw_buf)
+static int siw_hal_fw_parse_bin(struct device *dev, u8 *fw_buf,
+				struct siw_hal_fw_bin_info *bin)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
 	struct siw_ts *ts = chip->ts;
-	struct siw_hal_fw_info *fw = &chip->fw;
-	struct siw_touch_fquirks *fquirks = touch_fquirks(ts);
 	struct siw_hal_tc_version_bin *bin_ver;
 	int fw_max_size = touch_fw_size(ts);
 	u32 bin_ver_offset = 0;
-	u32 bin_ver_ext_offset = 0;
 	u32 bin_pid_offset = 0;
+
+	memset(bin, 0, sizeof(*bin));
+
+	bin_ver_offset = *((u32 *)&fw_buf[BIN_VER_OFFSET_POS]);
+	if (!bin_ver_offset) {
+		t_dev_err(dev, "FW compare: zero ver offset\n");
+		return -EINVAL;
+	}
+
+	switch (touch_chip_type(ts)) {
+	case CHIP_SW1828 :
+		bin->ver_ext_offset = *((u32 *)&fw_buf[BIN_VER_EXT_OFFSET_POS]);
+		break;
+	default:
+		bin->ver_ext_offset = 0;
+		break;
+	}
+
+	bin_pid_offset = *((u32 *)&fw_buf[BIN_PID_OFFSET_POS]);
+	if (!bin_pid_offset) {
+		t_dev_err(dev, "FW compare: zero pid offset\n");
+		return -EINVAL;
+	}
+
+	if ((bin_ver_offset > fw_max_size) ||
+		(bin->ver_ext_offset > fw_max_size) ||
+		(bin_pid_offset > fw_max_size)) {
+		t_dev_err(dev, "FW compare: invalid offset - ver %06Xh, ver_ext %06Xh pid %06Xh, max %06Xh\n",
+			bin_ver_offset, bin->ver_ext_offset, bin_pid_offset, fw_max_size);
+		return -EINVAL;
+	}
+
+	memcpy(bin->pid, &fw_buf[bin_pid_offset], 8);
+	t_dev_dbg_base(dev, "pid %s\n", bin->pid);
+
+	t_dev_dbg_base(dev, "ver %06Xh, ver_ext %06Xh, pid %06Xh\n",
+			bin_ver_offset, bin->ver_ext_offset, bin_pid_offset);
+
+	bin_ver = (struct siw_hal_tc_version_bin *)&fw_buf[bin_ver_offset];
+	bin->major = bin_ver->major;
+	bin->minor = bin_ver->minor;
+
+	if (bin->ver_ext_offset) {
+		if (!bin_ver->ext) {
+			t_dev_err(dev, "FW compare: (no ext flag in binary)\n");
+			return -EINVAL;
+		}
+
+		memcpy(&bin->raw_ext, &fw_buf[bin->ver_ext_offset], sizeof(bin->raw_ext));
+		bin->major = bin->raw_ext >> 8;
+		bin->minor = bin->raw_ext & 0xFF;
+
+		if (siw_hal_fw_chk_version_ext(bin->raw_ext,
+					bin_ver->ext) < 0) {
+			t_dev_err(dev, "FW compare: (invalid extension in binary)\n");
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * fw_buf is the cached image (siw_hal_fw_get_file),
+ * so its version info is parsed once
+ */
+static struct siw_hal_fw_bin_info *siw_hal_fw_get_bin_info(struct device *dev,
+				u8 *fw_buf)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_hal_fw_cache *cache = &chip->fw_cache;
+
+	if (!cache->bin_parsed) {
+		cache->bin_err = siw_hal_fw_parse_bin(dev, fw_buf, &cache->bin);
+		cache->bin_parsed = 1;
+	}
+
+	if (cache->bin_err < 0) {
+		return ERR_PTR(cache->bin_err);
+	}
+
+	return &cache->bin;
+}
+
+static int siw_hal_fw_compare(struct device *dev, u8 *fw_buf)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	struct siw_hal_fw_info *fw = &chip->fw;
+	struct siw_touch_fquirks *fquirks = touch_fquirks(ts);
+	struct siw_hal_fw_bin_info *bin;
 	u32 dev_major = 0;
 	u32 dev_minor = 0;
-	char pid[12] = {0, };
-	u32 bin_major = 0;
-	u32 bin_minor = 0;
-//	u32 bin_raw = 0;
-	u32 bin_raw_ext = 0;
 	int bin_diff = 0;
 	int update = 0;
 //	int ret = 0;
@@ -2346,23 +2817,13 @@ static int siw_hal_fw_compare(struct device *dev, u8 *fw_buf)
 		return 0;
 	}
 
-	bin_ver_offset = *((u32 *)&fw_buf[BIN_VER_OFFSET_POS]);
-	if (!bin_ver_offset) {
-		t_dev_err(dev, "FW compare: zero ver offset\n");
-		return -EINVAL;
+	bin = siw_hal_fw_get_bin_info(dev, fw_buf);
+	if (IS_ERR(bin)) {
+		return PTR_ERR(bin);
 	}
 
-	switch (touch_chip_type(ts)) {
-	case CHIP_SW1828 :
-		bin_ver_ext_offset = *((u32 *)&fw_buf[BIN_VER_EXT_OFFSET_POS]);
-		break;
-	default:
-		bin_ver_ext_offset = 0;
-		break;
-	}
-
-	if ((fw->version_ext && !bin_ver_ext_offset) ||
-		(!fw->version_ext && bin_ver_ext_offset)) {
+	if ((fw->version_ext && !bin->ver_ext_offset) ||
+		(!fw->version_ext && bin->ver_ext_offset)) {
 		if (!ts->force_fwup) {
 			t_dev_warn(dev,
 				"FW compare: different version format, "
@@ -2373,53 +2834,14 @@ static int siw_hal_fw_compare(struct device *dev, u8 *fw_buf)
 		bin_diff = 1;
 	}
 
-	bin_pid_offset = *((u32 *)&fw_buf[BIN_PID_OFFSET_POS]);
-	if (!bin_pid_offset) {
-		t_dev_err(dev, "FW compare: zero pid offset\n");
-		return -EINVAL;
-	}
-
-	memcpy(pid, &fw_buf[bin_pid_offset], 8);
-	t_dev_dbg_base(dev, "pid %s\n", pid);
-
-	if ((bin_ver_offset > fw_max_size) ||
-		(bin_ver_ext_offset > fw_max_size) ||
-		(bin_pid_offset > fw_max_size)) {
-		t_dev_err(dev, "FW compare: invalid offset - ver %06Xh, ver_ext %06Xh pid %06Xh, max %06Xh\n",
-			bin_ver_offset, bin_ver_ext_offset, bin_pid_offset, fw_max_size);
-		return -EINVAL;
-	}
-
-	t_dev_dbg_base(dev, "ver %06Xh, ver_ext %06Xh, pid %06Xh\n",
-			bin_ver_offset, bin_ver_ext_offset, bin_pid_offset);
-
-	bin_ver = (struct siw_hal_tc_version_bin *)&fw_buf[bin_ver_offset];
-	bin_major = bin_ver->major;
-	bin_minor = bin_ver->minor;
-
-	if (bin_ver_ext_offset) {
-		if (!bin_ver->ext) {
-			t_dev_err(dev, "FW compare: (no ext flag in binary)\n");
-			return -EINVAL;
-		}
-
-		memcpy(&bin_raw_ext, &fw_buf[bin_ver_ext_offset], sizeof(bin_raw_ext));
-		bin_major = bin_raw_ext >> 8;
-		bin_minor = bin_raw_ext & 0xFF;
-
+	if (bin->ver_ext_offset) {
 		t_dev_info(dev,
 			"FW compare: bin-ver: %08X (%s)(%d)\n",
-			bin_raw_ext, pid, bin_diff);
-
-		if (siw_hal_fw_chk_version_ext(bin_raw_ext,
-					bin_ver->ext) < 0) {
-			t_dev_err(dev, "FW compare: (invalid extension in binary)\n");
-			return -EINVAL;
-		}
+			bin->raw_ext, bin->pid, bin_diff);
 	} else {
 		t_dev_info(dev,
 			"FW compare: bin-ver: %d.%02d (%s)(%d)\n",
-			bin_major, bin_minor, pid, bin_diff);
+			bin->major, bin->minor, bin->pid, bin_diff);
 	}
 
 	if (fw->version_ext) {
@@ -2433,10 +2855,10 @@ static int siw_hal_fw_compare(struct device *dev, u8 *fw_buf)
 	if (ts->force_fwup) {
 		update |= (1<<0);
 	} else {
-		if (bin_major > dev_major) {
+		if (bin->major > dev_major) {
 			update |= (1<<1);
-		} else if (bin_major == dev_major) {
-			if (bin_minor > dev_minor) {
+		} else if (bin->major == dev_major) {
+			if (bin->minor > dev_minor) {
 				update |= (1<<2);
 			}
 		}
@@ -2450,32 +2872,78 @@ out:
 	return update;
 }
 
-#if defined(__FW_VERIFY_TEST)
+/*
+ * Code verify
+ *
+ * The code SRAM is read back in download-sized bursts and each
+ * burst is checked with memcmp. Only a burst that differs is walked
+ * to report the mismatched ranges.
+ */
+#define FW_VERIFY_RANGE_MAX		8
+
+static int __siw_hal_fw_up_verify_ranges(struct device *dev,
+				int base, u8 *rd, u8 *wr, int size, int *ranges)
+{
+	int start = -1;
+	int cnt = 0;
+	int i;
+
+	for (i = 0; i <= size; i++) {
+		if ((i < size) && (rd[i] != wr[i])) {
+			if (start < 0) {
+				start = i;
+			}
+			cnt++;
+			continue;
+		}
+
+		if (start < 0) {
+			continue;
+		}
+
+		if ((*ranges)++ < FW_VERIFY_RANGE_MAX) {
+			t_dev_err(dev, "FW verify: [%06Xh - %06Xh] mismatch, rd(%02X) != wr(%02X)\n",
+				base + start, base + i - 1, rd[start], wr[start]);
+		}
+		start = -1;
+	}
+
+	return cnt;
+}
+
 static int __siw_hal_fw_up_verify(struct device *dev, u8 *chk_buf, int chk_size)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
 //	struct siw_ts *ts = chip->ts;
 	struct siw_hal_reg *reg = chip->reg;
-	u8 *fw_rd_data, *fw_data;
-	u8 *r_data, *w_data;
-	int fw_size;
+	u8 *fw_rd_data;
 	int fw_pos, curr_size;
-	int i;
+	int burst;
+	int ranges = 0;
+	int err_cnt = 0;
 	int ret = 0;
 
-	fw_size = chk_size;
+	if (!t_fw_verify) {
+		return 0;
+	}
 
-	fw_rd_data = kmalloc(fw_size, GFP_KERNEL);
+	burst = siw_hal_fw_dn_burst_size(dev);
+
+	/* 1K read-back doubles the flash time, keep it opt-in there */
+	if ((t_fw_verify == 2) && (burst <= MAX_RW_SIZE)) {
+		return 0;
+	}
+
+	fw_rd_data = kmalloc(burst, GFP_KERNEL);
 	if (!fw_rd_data) {
 		t_dev_err(dev, "FW upgrade: failed to allocate verifying memory\n");
 		ret = -ENOMEM;
 		goto out;
 	}
 
-	fw_data = fw_rd_data;
 	fw_pos = 0;
-	while (fw_size && fw_data) {
-		curr_size = min(fw_size, MAX_RW_SIZE);
+	while (fw_pos < chk_size) {
+		curr_size = min(chk_size - fw_pos, burst);
 
 		/* code sram base address write */
 		ret = siw_hal_write_value(dev, reg->spr_code_offset, fw_pos>>2);
@@ -2484,51 +2952,37 @@ static int __siw_hal_fw_up_verify(struct device *dev, u8 *chk_buf, int chk_size)
 		}
 
 		ret = siw_hal_reg_read(dev, reg->code_access_addr,
-					(void *)fw_data, curr_size);
+					(void *)fw_rd_data, curr_size);
 		if (ret < 0) {
 			goto out_free;
 		}
 
-		fw_data += curr_size;
-		fw_pos += curr_size;
-		fw_size -= curr_size;
-	}
-
-	r_data = fw_rd_data;
-	w_data = chk_buf;
-	fw_size = chk_size;
-	for (i = 0; i < fw_size; i++) {
-		if ((*r_data) != (*w_data)) {
-			t_dev_err(dev, "* Err [%06X] rd(%02X) != wr(%02X)\n",
-				i, (*r_data), (*w_data));
-			ret = -EFAULT;
-		} else {
-		#if 0
-			t_dev_info(dev, "  OK! [%06X] rd(%02X) == wr(%02X)\n",
-				i, (*r_data), (*w_data));
-		#endif
+		if (memcmp(fw_rd_data, &chk_buf[fw_pos], curr_size)) {
+			err_cnt += __siw_hal_fw_up_verify_ranges(dev, fw_pos,
+						fw_rd_data, &chk_buf[fw_pos],
+						curr_size, &ranges);
 		}
 
-		r_data++;
-		w_data++;
+		fw_pos += curr_size;
 	}
 
-	if (ret >= 0) {
-		t_dev_info(dev, "FW dn verified\n");
+	if (err_cnt) {
+		t_dev_err(dev, "FW verify: %d bytes in %d ranges mismatched\n",
+			err_cnt, ranges);
+		ret = -EFAULT;
+		goto out_free;
 	}
 
+	ret = 0;
+	t_dev_info(dev, "FW dn verified (%d bytes, burst %d)\n",
+		chk_size, burst);
+
 out_free:
 	kfree(fw_rd_data);
 
 out:
 	return ret;
 }
-#else	/* __FW_VERIFY_TEST */
-static int __siw_hal_fw_up_verify(struct device *dev, u8 *chk_buf, int chk_size)
-{
-	return 0;
-}
-#endif	/* __FW_VERIFY_TEST */
 
 static int siw_hal_fw_upgrade_fw_pre(struct device *dev)
 {
@@ -2596,13 +3050,88 @@ out:
 	return ret;
 }
 
+/*
+ * Delta upgrade
+ *
+ * Against the block CRC manifest of the last image flashed by this
+ * driver, a stage (code or conf) whose blocks are all unchanged is
+ * skipped. A changed stage is downloaded in full: the flash commands
+ * program the whole sram anyway, and a partial write would need a
+ * full read-back to trust the untouched sram, costing about as much
+ * bus time as the full write it saves.
+ */
+static void siw_hal_fw_delta_calc(u8 *fw_buf, int fw_size, u32 *crc)
+{
+	int fw_pos = 0;
+	int curr_size;
+
+	while (fw_pos < fw_size) {
+		curr_size = min(fw_size - fw_pos, FW_DELTA_BLK_SZ);
+		*crc++ = crc32_le(~0, &fw_buf[fw_pos], curr_size);
+		fw_pos += curr_size;
+	}
+}
+
+static u32 siw_hal_fw_delta_conf_crc(struct device *dev, u8 *fw_buf)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	u32 crc;
+
+	crc = crc32_le(~0, &fw_buf[touch_fw_size(ts)], FLASH_CONF_SIZE_TYPE_X);
+
+	return siw_hal_fw_conf_crc_quirk(dev, fw_buf, crc);
+}
+
+static int siw_hal_fw_delta_usable(struct device *dev)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	struct siw_hal_fw_delta *delta = &chip->fw_delta;
+	struct siw_hal_fw_info *fw = &chip->fw;
+
+	if (!t_fw_delta || (delta->state != FW_DELTA_VALID)) {
+		return 0;
+	}
+
+	if (delta->code_size != touch_fw_size(ts)) {
+		return 0;
+	}
+
+	if ((delta->version_raw != fw->v.version_raw) ||
+		(delta->version_ext != fw->version_ext)) {
+		t_dev_info(dev, "FW delta: dev-ver changed, manifest dropped\n");
+		return 0;
+	}
+
+	return 1;
+}
+
+static int siw_hal_fw_delta_changed(u32 *old_crc, u32 *new_crc, int blks)
+{
+	int changed = 0;
+	int i;
+
+	for (i = 0; i < blks; i++) {
+		changed += !!(old_crc[i] != new_crc[i]);
+	}
+
+	return changed;
+}
+
+/*
+ * old_crc : manifest of the running code, NULL for full download
+ * new_crc : block CRCs of fw_buf
+ */
 static int siw_hal_fw_upgrade_fw(struct device *dev,
-				u8 *fw_buf, int fw_size)
+				u8 *fw_buf, int fw_size, u32 *old_crc, u32 *new_crc)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
 	struct siw_ts *ts = chip->ts;
 	u8 *fw_data;
 	int fw_size_max;
+	int blks;
+	int changed = 0;
 	int ret = 0;
 
 	/*
@@ -2610,6 +3139,21 @@ static int siw_hal_fw_upgrade_fw(struct device *dev,
 	 */
 	fw_size_max = touch_fw_size(ts);
 
+	if (old_crc) {
+		blks = DIV_ROUND_UP(fw_size_max, FW_DELTA_BLK_SZ);
+		changed = siw_hal_fw_delta_changed(old_crc, new_crc, blks);
+
+		if (!changed) {
+			t_dev_info(dev, "FW upgrade: code unchanged, skipped\n");
+			goto out;
+		}
+
+		t_dev_info(dev, "FW upgrade: code changed, %d of %d blocks\n",
+			changed, blks);
+	}
+
+	siw_touch_fwup_phase(ts, FWUP_PHASE_CODE);
+
 	ret = siw_hal_fw_upgrade_fw_pre(dev);
 	if (ret < 0) {
 		goto out;
@@ -2634,6 +3178,8 @@ static int siw_hal_fw_upgrade_fw(struct device *dev,
 	/*
 	 * Stage 1-2: upgrade code data
 	 */
+	siw_touch_fwup_phase(ts, FWUP_PHASE_FLASH);
+
 	ret = siw_hal_fw_upgrade_fw_post(dev);
 	if (ret < 0) {
 		goto out;
@@ -2713,6 +3259,8 @@ static int siw_hal_fw_upgrade_conf(struct device *dev,
 
 	fw_size_max = touch_fw_size(ts);
 
+	siw_touch_fwup_phase(ts, FWUP_PHASE_CONF);
+
 	/*
 	 * Stage 2-1: download config data
 	 */
@@ -2757,23 +3305,26 @@ out:
 	return ret;
 }
 
-static int siw_hal_fw_upgrade(struct device *dev,
-				u8 *fw_buf, int fw_size, int retry)
+static int siw_hal_fw_upgrade(struct device *dev, int retry)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
 	struct siw_ts *ts = chip->ts;
+	struct siw_hal_fw_delta *delta = &chip->fw_delta;
+	struct siw_hal_fwup *fwup = &chip->fwup;
+	u8 *fw_buf = fwup->fw_buf;
+	int fw_size = fwup->fw_size;
+	u32 *old_crc = NULL;
 	int fw_size_max;
+	int blks;
+	int code_dn;
+	int conf_dn = 0;
 	u32 include_conf;
 	int ret = 0;
 
 	t_dev_info(dev, "===== FW upgrade: start (%d) =====\n", retry);
 
 	fw_size_max = touch_fw_size(ts);
-
-	ret = siw_hal_fw_size_check(dev, fw_size);
-	if (ret < 0) {
-		goto out;
-	}
+	blks = DIV_ROUND_UP(fw_size_max, FW_DELTA_BLK_SZ);
 
 	include_conf = !!(fw_size > fw_size_max);
 	t_dev_info(dev, "FW upgrade:%s include conf data\n",
@@ -2782,18 +3333,52 @@ static int siw_hal_fw_upgrade(struct device *dev,
 	t_dev_dbg_base(dev, "FW upgrade: fw size %08Xh, fw_size_max %08Xh\n",
 			fw_size, fw_size_max);
 
-	ret = siw_hal_fw_upgrade_fw(dev, fw_buf, fw_size);
+	code_dn = fw_size_max;
+	if (include_conf) {
+		conf_dn = FLASH_CONF_SIZE_TYPE_X;
+		conf_dn += (chip->fw.conf_index) ? FLASH_CONF_SIZE : 0;
+	}
+
+	if (siw_hal_fw_delta_usable(dev)) {
+		old_crc = delta->code_crc;
+		if (!siw_hal_fw_delta_changed(old_crc, fwup->code_crc, blks)) {
+			code_dn = 0;
+		}
+
+		if (include_conf && delta->conf_valid &&
+			(delta->conf_index == chip->fw.conf_index) &&
+			(delta->conf_crc == fwup->conf_crc)) {
+			t_dev_info(dev, "FW upgrade: conf unchanged, skipped\n");
+			conf_dn = 0;
+		}
+	}
+
+	/* dropped until this upgrade is done */
+	delta->state = FW_DELTA_NONE;
+
+	siw_touch_fwup_dn_total(ts, code_dn + conf_dn);
+
+	ret = siw_hal_fw_upgrade_fw(dev, fw_buf, fw_size, old_crc, fwup->code_crc);
 	if (ret < 0) {
 		goto out;
 	}
 
-	if (include_conf) {
+	if (conf_dn) {
 		ret = siw_hal_fw_upgrade_conf(dev, fw_buf, fw_size);
 		if (ret < 0) {
 			goto out;
 		}
 	}
 
+	kfree(delta->code_crc);
+	delta->code_crc = fwup->code_crc;
+	delta->code_size = fw_size_max;
+	delta->conf_valid = include_conf;
+	delta->conf_index = chip->fw.conf_index;
+	delta->conf_crc = fwup->conf_crc;
+	delta->state = FW_DELTA_PENDING;
+	fwup->code_crc = NULL;
+
 	t_dev_info(dev, "===== FW upgrade: done (%d) =====\n", retry);
 
 out:
@@ -2849,48 +3434,162 @@ static int siw_hal_fw_do_get_fw_abs(const struct firmware **fw_p,
 		goto out;
 	}
 
-	fw->data = buf;
-	fw->size = size;
-	fw->priv = ts;		//for identification
+	fw->data = buf;
+	fw->size = size;
+	fw->priv = ts;		//for identification
+
+	if (fw_p) {
+		*fw_p = fw;
+	}
+
+	filp_close(filp, 0);
+
+	return 0;
+
+out:
+	if (buf)
+		kfree(buf);
+
+	if (fw)
+		kfree(fw);
+
+	filp_close(filp, 0);
+
+	return ret;
+}
+
+static int siw_hal_fw_do_get_file(const struct firmware **fw_p,
+				const char *name,
+                struct device *dev,
+                int abs_path)
+{
+	if (abs_path) {
+		return siw_hal_fw_do_get_fw_abs(fw_p, name, dev);
+	}
+
+	return request_firmware(fw_p, name, dev);
+}
+
+static void siw_hal_fw_release_firm(struct device *dev,
+			const struct firmware *fw)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+
+	if (fw->priv == (void *)ts) {
+		kfree(fw->data);
+		kfree(fw);
+		return;
+	}
+
+	release_firmware(fw);
+}
+
+/*
+ * F/W image cache
+ *
+ * The image, its parsed version info and block crc are kept until
+ * the path or, for the absolute path, its size or mtime changes,
+ * so that the repeated upgrade check (e.g. MFTS resume) doesn't
+ * touch the file system.
+ * A request_firmware image doesn't change under the same name
+ * and is reloaded only by an explicit fw_upgrade store.
+ * All of these run under chip->fwup_lock.
+ */
+static void siw_hal_fw_cache_drop(struct device *dev)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_hal_fw_cache *cache = &chip->fw_cache;
+
+	if (cache->fw) {
+		siw_hal_fw_release_firm(dev, cache->fw);
+	}
+	kfree(cache->path);
+	kfree(cache->code_crc);
+
+	memset(cache, 0, sizeof(*cache));
+}
 
-	if (fw_p) {
-		*fw_p = fw;
+static int siw_hal_fw_file_stat(struct device *dev, const char *name,
+				loff_t *size, long *mtime_sec, long *mtime_nsec)
+{
+	struct file *filp = NULL;
+	struct inode *inode;
+
+	filp = filp_open(name, O_RDONLY, 0);
+	if (IS_ERR(filp)) {
+		return (int)PTR_ERR(filp);
 	}
 
+	inode = filp->f_path.dentry->d_inode;
+	*size = i_size_read(inode);
+	*mtime_sec = inode->i_mtime.tv_sec;
+	*mtime_nsec = inode->i_mtime.tv_nsec;
+
 	filp_close(filp, 0);
 
 	return 0;
+}
 
-out:
-	if (buf)
-		kfree(buf);
+/*
+ * Returns 1 if fwpath is the image already cached
+ */
+static int siw_hal_fw_cache_hit(struct device *dev,
+				const char *fwpath, int abs_path)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	struct siw_hal_fw_cache *cache = &chip->fw_cache;
+	loff_t size = 0;
+	long mtime_sec = 0;
+	long mtime_nsec = 0;
 
-	if (fw)
-		kfree(fw);
+	if (!cache->valid || (cache->path == NULL)) {
+		return 0;
+	}
 
-	filp_close(filp, 0);
+	if ((cache->abs_path != abs_path) || strcmp(cache->path, fwpath)) {
+		return 0;
+	}
 
-	return ret;
+	if (!abs_path) {
+		return !(ts->force_fwup & FORCE_FWUP_SYS_STORE);
+	}
+
+	if (siw_hal_fw_file_stat(dev, fwpath, &size, &mtime_sec, &mtime_nsec) < 0) {
+		return 0;
+	}
+
+	return (cache->size == size) &&
+		(cache->mtime_sec == mtime_sec) &&
+		(cache->mtime_nsec == mtime_nsec);
 }
 
-static int siw_hal_fw_do_get_file(const struct firmware **fw_p,
-				const char *name,
-                struct device *dev,
-                int abs_path)
+static int siw_hal_fw_cache_bin(struct device *dev,
+				u8 *fw_buf, int fw_size)
 {
-	if (abs_path) {
-		return siw_hal_fw_do_get_fw_abs(fw_p, name, dev);
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_hal_fw_cache *cache = &chip->fw_cache;
+
+	if (cache->valid && (cache->path == NULL) &&
+		(cache->fw_buf == fw_buf) && (cache->fw_size == fw_size)) {
+		return 0;
 	}
 
-	return request_firmware(fw_p, name, dev);
+	siw_hal_fw_cache_drop(dev);
+
+	cache->fw_buf = fw_buf;
+	cache->fw_size = fw_size;
+	cache->valid = 1;
+
+	return 0;
 }
 
-static int siw_hal_fw_get_file(const struct firmware **fw_p,
-				char *fwpath,
-				struct device *dev)
+static int siw_hal_fw_get_file(char *fwpath, struct device *dev)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
 	struct siw_ts *ts = chip->ts;
+	struct siw_hal_fw_cache *cache = &chip->fw_cache;
 	const struct firmware *fw = NULL;
 	char *src_path;
 	int src_len;
@@ -2930,10 +3629,19 @@ static int siw_hal_fw_get_file(const struct firmware **fw_p,
 	strncpy(fwpath, src_path, src_len);
 	fwpath[src_len] = 0;
 
+	if (siw_hal_fw_cache_hit(dev, fwpath, abs_path)) {
+		t_dev_info(dev, "target fw: %s (%s, cached)\n",
+			fwpath,
+			(abs_path) ? "abs" : "rel");
+		goto out;
+	}
+
 	t_dev_info(dev, "target fw: %s (%s)\n",
 		fwpath,
 		(abs_path) ? "abs" : "rel");
 
+	siw_hal_fw_cache_drop(dev);
+
 	ret = siw_hal_fw_do_get_file(&fw,
 				(const char *)fwpath,
 				dev, abs_path);
@@ -2948,67 +3656,65 @@ static int siw_hal_fw_get_file(const struct firmware **fw_p,
 		goto out;
 	}
 
-	if (fw_p) {
-		*fw_p = fw;
+	cache->fw = fw;
+	cache->fw_buf = (u8 *)fw->data;
+	cache->fw_size = (int)fw->size;
+	cache->abs_path = abs_path;
+	cache->path = kstrdup(fwpath, GFP_KERNEL);
+	if (abs_path && (cache->path != NULL)) {
+		if (siw_hal_fw_file_stat(dev, fwpath, &cache->size,
+				&cache->mtime_sec, &cache->mtime_nsec) < 0) {
+			/* not to be hit */
+			kfree(cache->path);
+			cache->path = NULL;
+		}
 	}
+	cache->valid = (cache->path != NULL);
 
 out:
 	return ret;
 }
 
-static void siw_hal_fw_release_firm(struct device *dev,
-			const struct firmware *fw)
+static void siw_hal_upgrade_release(struct device *dev)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
-	struct siw_ts *ts = chip->ts;
+	struct siw_hal_fwup *fwup = &chip->fwup;
 
-	if (fw->priv == (void *)ts) {
-		kfree(fw->data);
-		kfree(fw);
-		return;
-	}
+	kfree(fwup->code_crc);
 
-	release_firmware(fw);
+	memset(fwup, 0, sizeof(*fwup));
+
+	if (!t_fw_cache) {
+		siw_hal_fw_cache_drop(dev);
+	}
 }
 
 /*
- * FW upgrade option
- *
- * 1. If TOUCH_USE_FW_BINARY used
- * 1-1 Default upgrade (through version comparison)
- *     do upgarde using binary header link
- * 1-2 echo {bin} > fw_upgrade
- *     do force-upgrade using binary header link (same as 1-1)
- * 1-3 echo /.../fw_img > fw_upgrade
- *     do force-upgrade using request_firmware (relative path)
- * 1-4 echo {root}/.../fw_img > fw_upgrade
- *     do force-upgrade using normal file open control (absolute path)
+ * Stage 0 : fetch and check the image with touch alive
  *
- * 2. Else
- * 2-1 Default upgrade (through version comparison)
- *     do upgarde using request_firmware (relative path)
- * 2-2 echo /.../fw_img > fw_upgrade
- *     do force-upgrade using request_firmware (relative path)
- * 2-3 echo {root}/.../fw_img > fw_upgrade
- *     do force-upgrade using normal file open control (absolute path)
+ * Returns 0 when the image is ready for __siw_hal_upgrade,
+ * -EPERM when no upgrade is required.
+ * Caller holds chip->fwup_lock.
  */
-static int siw_hal_upgrade(struct device *dev)
+static int __siw_hal_upgrade_prep(struct device *dev)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
 	struct siw_ts *ts = chip->ts;
+	struct siw_hal_fwup *fwup = &chip->fwup;
+	struct siw_hal_fw_cache *cache = &chip->fw_cache;
 	struct siw_touch_fw_bin *fw_bin = NULL;
-	const struct firmware *fw = NULL;
 	char *fwpath = NULL;
 	u8 *fw_buf = NULL;
 	int fw_max_size = touch_fw_size(ts);
 	int fw_size = 0;
 	int fw_up_binary = 0;
-	int i = 0;
 	int ret_val = 0;
 	int ret = 0;
 
 	t_dev_info(dev, "fw type: %s\n", FW_TYPE_STR);
 
+	siw_hal_upgrade_release(dev);
+
 	if (atomic_read(&ts->state.fb) >= FB_SUSPEND) {
 		t_dev_warn(dev, "state.fb is not FB_RESUME\n");
 		return -EPERM;
@@ -3046,19 +3752,25 @@ static int siw_hal_upgrade(struct device *dev)
 		if (fw_bin != NULL) {
 			fw_buf = fw_bin->fw_data;
 			fw_size = fw_bin->fw_size;
+			siw_hal_fw_cache_bin(dev, fw_buf, fw_size);
 		} else {
 			t_dev_warn(dev, "empty fw info\n");
 		}
 	} else {
 		t_dev_info(dev, "getting fw from file\n");
-		ret = siw_hal_fw_get_file(&fw, fwpath, dev);
+		ret = siw_hal_fw_get_file(fwpath, dev);
 		if (ret < 0) {
 			goto out;
 		}
-		fw_buf = (u8 *)fw->data;
-		fw_size = (int)fw->size;
+		fw_buf = cache->fw_buf;
+		fw_size = cache->fw_size;
 	}
 
+	fwup->fw_buf = fw_buf;
+	fwup->fw_size = fw_size;
+
+	siw_touch_fwup_phase(ts, FWUP_PHASE_CHECK);
+
 //	ret = -EINVAL;
 	ret = -EPERM;
 
@@ -3076,20 +3788,103 @@ static int siw_hal_upgrade(struct device *dev)
 	t_dev_info(dev, "fw size: %d\n", fw_size);
 
 	ret_val = siw_hal_fw_compare(dev, fw_buf);
-	if (ret_val < 0) {
-		ret = ret_val;
-	} else if (ret_val) {
-		touch_msleep(200);
-		for (i = 0; i < 2 && ret; i++) {
-			ret = siw_hal_fw_upgrade(dev, fw_buf, fw_size, i);
+	if (ret_val <= 0) {
+		ret = (ret_val < 0) ? ret_val : -EPERM;
+		goto out;
+	}
+
+	ret = siw_hal_fw_size_check(dev, fw_size);
+	if (ret < 0) {
+		goto out;
+	}
+
+	if (cache->code_crc == NULL) {
+		cache->code_crc = kcalloc(DIV_ROUND_UP(fw_max_size, FW_DELTA_BLK_SZ),
+						sizeof(u32), GFP_KERNEL);
+		if (cache->code_crc == NULL) {
+			t_dev_err(dev, "FW upgrade: failed to allocate block crc\n");
+			ret = -ENOMEM;
+			goto out;
 		}
+		siw_hal_fw_delta_calc(fw_buf, fw_max_size, cache->code_crc);
+	}
+
+	/* the copy goes to the delta manifest */
+	fwup->code_crc = kmemdup(cache->code_crc,
+				DIV_ROUND_UP(fw_max_size, FW_DELTA_BLK_SZ) * sizeof(u32),
+				GFP_KERNEL);
+	if (fwup->code_crc == NULL) {
+		t_dev_err(dev, "FW upgrade: failed to allocate block crc\n");
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	if (fw_size > fw_max_size) {
+		fwup->conf_crc = siw_hal_fw_delta_conf_crc(dev, fw_buf);
+	}
+
+	fwup->prepared = 1;
+
+out:
+	if (ret) {
+		siw_hal_upgrade_release(dev);
+
+		siwmon_submit_ops_step_chip_wh_name(dev, "%s - FW upgrade halted",
+				touch_chip_name(ts), ret);
+	}
+
+	touch_putname(fwpath);
+
+	return ret;
+}
+
+/*
+ * FW upgrade option
+ *
+ * 1. If TOUCH_USE_FW_BINARY used
+ * 1-1 Default upgrade (through version comparison)
+ *     do upgarde using binary header link
+ * 1-2 echo {bin} > fw_upgrade
+ *     do force-upgrade using binary header link (same as 1-1)
+ * 1-3 echo /.../fw_img > fw_upgrade
+ *     do force-upgrade using request_firmware (relative path)
+ * 1-4 echo {root}/.../fw_img > fw_upgrade
+ *     do force-upgrade using normal file open control (absolute path)
+ *
+ * 2. Else
+ * 2-1 Default upgrade (through version comparison)
+ *     do upgarde using request_firmware (relative path)
+ * 2-2 echo /.../fw_img > fw_upgrade
+ *     do force-upgrade using request_firmware (relative path)
+ * 2-3 echo {root}/.../fw_img > fw_upgrade
+ *     do force-upgrade using normal file open control (absolute path)
+ *
+ * Stage 1 : write the prepared image
+ * Caller holds chip->fwup_lock.
+ */
+static int __siw_hal_upgrade(struct device *dev)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	int i = 0;
+	int ret = 0;
+
+	if (atomic_read(&ts->state.fb) >= FB_SUSPEND) {
+		t_dev_warn(dev, "state.fb is not FB_RESUME\n");
+		ret = -EPERM;
+		goto out;
 	}
 
-	if (fw) {
-		siw_hal_fw_release_firm(dev, fw);
+	touch_msleep(200);
+
+	ret = -EPERM;
+	for (i = 0; i < 2 && ret; i++) {
+		ret = siw_hal_fw_upgrade(dev, i);
 	}
 
 out:
+	siw_hal_upgrade_release(dev);
+
 	if (ret) {
 		siwmon_submit_ops_step_chip_wh_name(dev, "%s - FW upgrade halted",
 				touch_chip_name(ts), ret);
@@ -3098,7 +3893,76 @@ out:
 				touch_chip_name(ts), ret);
 	}
 
-	touch_putname(fwpath);
+	return ret;
+}
+
+/*
+ * upgrade_work : siw_hal_upgrade_prep (no ts->lock),
+ *                then siw_hal_upgrade (ts->lock, irq disabled)
+ *
+ * fwup_lock is taken inside ts->lock, never the other way round,
+ * and only the work path leaves an image prepared in between.
+ */
+static int siw_hal_upgrade_prep(struct device *dev)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	int ret;
+
+	mutex_lock(&chip->fwup_lock);
+	ret = __siw_hal_upgrade_prep(dev);
+	mutex_unlock(&chip->fwup_lock);
+
+	return ret;
+}
+
+static int siw_hal_upgrade(struct device *dev)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	int ret = 0;
+
+	mutex_lock(&chip->fwup_lock);
+
+	if (!chip->fwup.prepared) {
+		ret = __siw_hal_upgrade_prep(dev);
+		if (ret < 0) {
+			goto out;
+		}
+	}
+
+	ret = __siw_hal_upgrade(dev);
+
+out:
+	mutex_unlock(&chip->fwup_lock);
+
+	return ret;
+}
+
+/*
+ * Direct upgrade out of upgrade_work (MFTS resume)
+ * An image left prepared belongs to upgrade_work, which will write it.
+ */
+static int siw_hal_upgrade_sync(struct device *dev)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	int ret = 0;
+
+	mutex_lock(&chip->fwup_lock);
+
+	if (chip->fwup.prepared) {
+		t_dev_info(dev, "FW upgrade: work pending, skipped\n");
+		ret = -EBUSY;
+		goto out;
+	}
+
+	ret = __siw_hal_upgrade_prep(dev);
+	if (ret < 0) {
+		goto out;
+	}
+
+	ret = __siw_hal_upgrade(dev);
+
+out:
+	mutex_unlock(&chip->fwup_lock);
 
 	return ret;
 }
@@ -4468,8 +5332,8 @@ static int siw_hal_check_status(struct device *dev)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
 //	struct siw_ts *ts = chip->ts;
-	u32 ic_status = chip->info.ic_status;
-	u32 status = chip->info.device_status;
+	u32 ic_status = chip->info_p->ic_status;
+	u32 status = chip->info_p->device_status;
 
 	return siw_hal_do_check_status(dev, status, ic_status, 1);
 }
@@ -4478,14 +5342,14 @@ static int siw_hal_irq_abs_data(struct device *dev)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
 	struct siw_ts *ts = chip->ts;
-	struct siw_hal_touch_data *data = chip->info.data;
+	struct siw_hal_touch_data *data = chip->info_p->data;
 	struct touch_data *tdata;
 	u32 touch_count = 0;
 	u8 finger_index = 0;
 	int ret = 0;
 	int i = 0;
 
-	touch_count = chip->info.touch_cnt;
+	touch_count = chip->info_p->touch_cnt;
 	ts->new_mask = 0;
 
 	/* check if palm detected */
@@ -4502,7 +5366,7 @@ static int siw_hal_irq_abs_data(struct device *dev)
 		return ret;
 	}
 
-	data = chip->info.data;
+	data = chip->info_p->data;
 	for (i = 0; i < touch_count; i++, data++) {
 		if (data->track_id >= touch_max_finger(ts)) {
 			continue;
@@ -4553,13 +5417,14 @@ static int siw_hal_irq_abs(struct device *dev)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
 	struct siw_ts *ts = chip->ts;
+	struct siw_hal_touch_info *info = chip->info_p;
 
 	/* check if touch cnt is valid */
-	if (chip->info.touch_cnt == 0 || chip->info.touch_cnt > ts->caps.max_id) {
-		struct siw_hal_touch_data *data = chip->info.data;
+	if (info->touch_cnt == 0 || info->touch_cnt > ts->caps.max_id) {
+		struct siw_hal_touch_data *data = info->data;
 
 		t_dev_dbg_abs(dev, "Invalid touch count, %d(%d)\n",
-				chip->info.touch_cnt, ts->caps.max_id);
+				info->touch_cnt, ts->caps.max_id);
 
 		/* debugging */
 		t_dev_dbg_abs(dev, "t %d, ev %d, id %d, x %d, y %d, p %d, a %d, w %d %d\n",
@@ -4585,7 +5450,7 @@ static int siw_hal_get_tci_data(struct device *dev, int count)
 
 	ts->lpwg.code_num = count;
 
-	memcpy(&rdata, chip->info.data, sizeof(u32) * count);
+	memcpy(&rdata, chip->info_p->data, sizeof(u32) * count);
 
 	for (i = 0; i < count; i++) {
 		ts->lpwg.code[i].x = rdata[i] & 0xffff;
@@ -4612,7 +5477,7 @@ static int siw_hal_get_swipe_data(struct device *dev)
 
 	/* swipe_info */
 	/* start (X, Y), end (X, Y), time = 2bytes * 5 = 10 bytes */
-	memcpy(&rdata, chip->info.data, sizeof(u32) * 3);
+	memcpy(&rdata, chip->info_p->data, sizeof(u32) * 3);
 
 	t_dev_info(dev,
 			"Swipe Gesture: start(%4d, %4d) end(%4d, %4d) swipe_time(%dms)\n",
@@ -4727,7 +5592,7 @@ static int siw_hal_irq_lpwg(struct device *dev)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
 	struct siw_ts *ts = chip->ts;
-	u32 type = chip->info.wakeup_type;
+	u32 type = chip->info_p->wakeup_type;
 	int ret = 0;
 
 	if (!type || (type > KNOCK_OVERTAP)) {
@@ -4756,11 +5621,111 @@ out:
 	return -EINVAL;
 }
 
-static int siw_hal_irq_handler(struct device *dev)
+/*
+ * IRQ_USE_ZERO_COPY :
+ * the touch report is decoded in place from the irq rx slot
+ * instead of being copied into chip->info
+ */
+static int siw_hal_irq_do_read_info(struct device *dev, int offs, int size)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
 	struct siw_ts *ts = chip->ts;
 	struct siw_hal_reg *reg = chip->reg;
+	struct siw_hal_irq_stat *stat = &chip->irq_stat;
+	u8 *info = (u8 *)&chip->info;
+	void *data = NULL;
+	int ret = 0;
+
+	if (touch_flags(ts) & IRQ_USE_ZERO_COPY) {
+		/* The irq slot can't be appended, top-up is a full re-read */
+		size += offs;
+		offs = 0;
+
+		ret = siw_hal_reg_read_irq(dev, reg->tc_ic_status, &data, size);
+		if ((ret != -EOVERFLOW) && (ret != -ENOMEM)) {
+			if (ret >= 0) {
+				chip->info_p = (struct siw_hal_touch_info *)data;
+				stat->rd_last += size;
+				stat->rd_total += size;
+			}
+			return ret;
+		}
+	}
+
+#if defined(__SIW_I2C_TYPE_1)
+	/* The address fix-up only covers the head of the report */
+	if (offs && (touch_bus_type(ts) == BUS_IF_I2C)) {
+		size += offs;
+		offs = 0;
+	}
+#endif
+
+	chip->info_p = &chip->info;
+
+	ret = siw_hal_reg_read(dev, reg->tc_ic_status + (offs>>2),
+				(void *)&info[offs], size);
+	if (ret >= 0) {
+		stat->rd_last += size;
+		stat->rd_total += size;
+		stat->copy_last += size;
+		stat->copy_total += size;
+	}
+
+	return ret;
+}
+
+/*
+ * Adaptive read :
+ * the first read covers the status words and as many records as
+ * the previous frame reported, the rest is topped up only when
+ * more fingers appear
+ */
+static int siw_hal_irq_read_info(struct device *dev)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_hal_irq_stat *stat = &chip->irq_stat;
+	struct siw_hal_touch_info *info = NULL;
+	int hint = chip->irq_cnt_hint;
+	int size = 0;
+	int need = 0;
+	int cnt = 0;
+	int ret = 0;
+
+	stat->cnt++;
+	stat->rd_last = 0;
+	stat->copy_last = 0;
+
+	hint = max(hint, 1);
+	hint = min(hint, MAX_FINGER);
+	size = TOUCH_INFO_SIZE(hint);
+
+	ret = siw_hal_irq_do_read_info(dev, 0, size);
+	if (ret < 0) {
+		return ret;
+	}
+
+	info = chip->info_p;
+	if (info->wakeup_type == ABS_MODE) {
+		cnt = min_t(int, info->touch_cnt, MAX_FINGER);
+		chip->irq_cnt_hint = cnt;
+	} else {
+		/* lpwg data */
+		cnt = MAX_FINGER;
+	}
+
+	need = TOUCH_INFO_SIZE(cnt);
+	if (need > size) {
+		stat->topup++;
+		ret = siw_hal_irq_do_read_info(dev, size, need - size);
+	}
+
+	return ret;
+}
+
+static int siw_hal_irq_handler(struct device *dev)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
 	int ret = 0;
 
 	if (atomic_read(&chip->init) == IC_INIT_NEED) {
@@ -4771,9 +5736,9 @@ static int siw_hal_irq_handler(struct device *dev)
 #if defined(__SIW_SUPPORT_PM_QOS)
 	pm_qos_update_request(&chip->pm_qos_req, 10);
 #endif
-	ret = siw_hal_reg_read(dev,
-				reg->tc_ic_status,
-				(void *)&chip->info, sizeof(chip->info));
+	siw_touch_lat_stamp(ts, SIW_LAT_RD_START);
+	ret = siw_hal_irq_read_info(dev);
+	siw_touch_lat_stamp(ts, SIW_LAT_RD_END);
 #if defined(__SIW_SUPPORT_PM_QOS)
 	pm_qos_update_request(&chip->pm_qos_req, PM_QOS_DEFAULT_VALUE);
 #endif
@@ -4787,14 +5752,15 @@ static int siw_hal_irq_handler(struct device *dev)
 	}
 
 	t_dev_dbg_irq(dev, "hal irq handler: wakeup_type %d\n",
-			chip->info.wakeup_type);
+			chip->info_p->wakeup_type);
 
-	if (chip->info.wakeup_type == ABS_MODE) {
+	if (chip->info_p->wakeup_type == ABS_MODE) {
 		ret = siw_hal_irq_abs(dev);
 		if (ret) {
 			t_dev_err(dev, "siw_hal_irq_abs failed, %d/n", ret);
 			goto out;
 		}
+		siw_touch_lat_stamp(ts, SIW_LAT_DECODE);
 	} else {
 		ret = siw_hal_irq_lpwg(dev);
 		if (ret) {
@@ -5597,6 +6563,7 @@ static int siw_hal_probe(struct device *dev)
 	chip->dev = dev;
 	chip->reg = siw_ops_reg(ts);
 	chip->ts = ts;
+	chip->info_p = &chip->info;
 
 	touch_set_dev_data(ts, chip);
 
@@ -5660,6 +6627,12 @@ static int siw_hal_remove(struct device *dev)
 	pm_qos_remove_request(&chip->pm_qos_req);
 #endif
 
+	mutex_lock(&chip->fwup_lock);
+	siw_hal_upgrade_release(dev);
+	siw_hal_fw_cache_drop(dev);
+	mutex_unlock(&chip->fwup_lock);
+	kfree(chip->fw_delta.code_crc);
+
 	siw_hal_free_works(chip);
 	siw_hal_free_locks(chip);
 
@@ -5725,7 +6698,7 @@ static int siw_hal_resume(struct device *dev)
 		if (ret < 0) {
 			t_dev_err(dev, "ic info err, %d\n", ret);
 		}
-		if (siw_hal_upgrade(dev) == 0) {
+		if (siw_hal_upgrade_sync(dev) == 0) {
 			siw_hal_power(dev, POWER_OFF);
 			siw_hal_power(dev, POWER_ON);
 			touch_msleep(ts->caps.hw_reset_delay);
@@ -5895,6 +6868,7 @@ static const struct siw_touch_operations siw_touch_default_ops = {
 	.irq_abs			= siw_hal_irq_abs,
 	.irq_lpwg			= siw_hal_irq_lpwg,
 	.power				= siw_hal_power,
+	.upgrade_prep		= siw_hal_upgrade_prep,
 	.upgrade			= siw_hal_upgrade,
 	.lpwg				= siw_hal_lpwg,
 	.asc				= siw_hal_asc,
@@ -45,6 +45,10 @@ struct siw_hal_touch_info {
 	struct siw_hal_touch_data data[MAX_FINGER];
 } __packed;
 
+#define TOUCH_INFO_HDR_SIZE		offsetof(struct siw_hal_touch_info, data)
+#define TOUCH_INFO_SIZE(_cnt)	\
+		(TOUCH_INFO_HDR_SIZE + (sizeof(struct siw_hal_touch_data) * (_cnt)))
+
 #define PALM_ID					15
 
 enum {
@@ -230,6 +234,74 @@ struct siw_hal_fw_info {
 	u32 conf_index;
 };
 
+/*
+ * Block CRC manifest of the last image flashed by this driver
+ * (see siw_hal_fw_upgrade)
+ */
+enum {
+	FW_DELTA_NONE = 0,
+	FW_DELTA_PENDING,	/* flashed, waiting for ic_info */
+	FW_DELTA_VALID,
+};
+
+#define FW_DELTA_BLK_SZ			MAX_RW_SIZE
+
+struct siw_hal_fw_delta {
+	int state;
+	u32 version_raw;
+	u32 version_ext;
+	int code_size;
+	u32 *code_crc;
+	int conf_valid;
+	u32 conf_index;
+	u32 conf_crc;
+};
+
+/*
+ * Version info parsed from the binary (siw_hal_fw_compare)
+ */
+struct siw_hal_fw_bin_info {
+	u32 ver_ext_offset;		/* non-zero for ext version format */
+	u32 major;
+	u32 minor;
+	u32 raw_ext;
+	char pid[12];
+};
+
+/*
+ * Last F/W image with its parsed info and block crc,
+ * kept across upgrades (see siw_hal_fw_get_file)
+ * chip->fwup_lock, as fwup->fw_buf points into it
+ */
+struct siw_hal_fw_cache {
+	int valid;
+	char *path;				/* NULL for binary header data */
+	int abs_path;
+	loff_t size;
+	long mtime_sec;
+	long mtime_nsec;
+	const struct firmware *fw;
+	u8 *fw_buf;
+	int fw_size;
+	int bin_parsed;
+	int bin_err;
+	struct siw_hal_fw_bin_info bin;
+	u32 *code_crc;
+};
+
+/*
+ * Image prepared with touch alive (siw_hal_upgrade_prep)
+ * and written by siw_hal_upgrade, both from upgrade_work.
+ * chip->fwup_lock
+ */
+struct siw_hal_fwup {
+	int prepared;
+	u8 *fw_buf;
+	int fw_size;
+	u32 *code_crc;
+	u32 conf_crc;
+};
+
 static inline void siw_hal_fw_set_chip_id(struct siw_hal_fw_info *fw, u32 chip_id)
 {
 	fw->chip_id_raw = chip_id;
@@ -285,6 +357,20 @@ static inline void siw_hal_fw_set_version(struct siw_hal_fw_info *fw,
 	fw->version_ext = (fw->v.version.ext) ? version_ext : 0;
 }
 
+/*
+ * The manifest is bound to the version read after the upgrade
+ */
+static inline void siw_hal_fw_delta_sync(struct siw_hal_fw_delta *delta,
+						struct siw_hal_fw_info *fw)
+{
+	if (delta->state != FW_DELTA_PENDING)
+		return;
+
+	delta->version_raw = fw->v.version_raw;
+	delta->version_ext = fw->version_ext;
+	delta->state = FW_DELTA_VALID;
+}
+
 static inline void siw_hal_fw_set_revision(struct siw_hal_fw_info *fw, u32 revision)
 {
 	fw->revision = revision & 0xFF;
@@ -319,13 +405,28 @@ struct siw_hal_swipe_ctrl {
 	struct siw_hal_swipe_info info[2]; /* down is 0, up 1 - LG4894 use up */
 };
 
+struct siw_hal_irq_stat {
+	u32 cnt;
+	u32 topup;
+	u32 rd_last;
+	u64 rd_total;
+	u32 copy_last;
+	u64 copy_total;
+};
+
 struct siw_touch_chip {
 	void *ts;			//struct siw_ts
 	struct siw_hal_reg *reg;
 	struct device *dev;
 	struct kobject kobj;
 	struct siw_hal_touch_info info;
+	struct siw_hal_touch_info *info_p;	/* &info or irq rx slot */
+	struct siw_hal_irq_stat irq_stat;
+	int irq_cnt_hint;
 	struct siw_hal_fw_info fw;
+	struct siw_hal_fw_delta fw_delta;
+	struct siw_hal_fw_cache fw_cache;
+	struct siw_hal_fwup fwup;
 	struct siw_hal_asc_info asc;
 	struct siw_hal_swipe_ctrl swipe;
 	u8 prev_lcd_mode;
@@ -334,6 +435,7 @@ struct siw_touch_chip {
 	u8 u3fake;
 	void *watch;
 	struct mutex bus_lock;
+	struct mutex fwup_lock;		/* fwup and fw_cache, never held while taking ts->lock */
 	struct delayed_work font_download_work;
 	struct delayed_work fb_notify_work;
 	u32 charger;
@@ -396,6 +498,38 @@ extern int siw_hal_xfer_msg(struct device *dev, struct touch_xfer_msg *xfer);
 extern void siw_hal_xfer_add_rx(void *xfer_data, u32 reg, void *buf, u32 size);
 extern void siw_hal_xfer_add_tx(void *xfer_data, u32 reg, void *buf, u32 size);
 
+/*
+ * Preassembled xfer (touch_xfer_allowed)
+ * The bus headers are built once by siw_hal_xfer_tmpl_add and
+ * only the payload sizes are given per run
+ */
+enum {
+	SIW_HAL_XFER_HDR_MAX	= (2 + 16),	/* SPI tx hdr + 128-bit dummy */
+};
+
+struct siw_hal_xfer_ent {
+	u32 addr;
+	u8 hdr[SIW_HAL_XFER_HDR_MAX];
+	u8 hdr_size;
+	u8 rd;
+};
+
+struct siw_hal_xfer_tmpl {
+	struct siw_hal_xfer_ent ent[SIW_TOUCH_MAX_XFER_COUNT];
+	int cnt;
+};
+
+struct siw_hal_xfer_io {
+	void *buf;
+	int size;
+};
+
+extern void siw_hal_xfer_tmpl_init(struct device *dev, struct siw_hal_xfer_tmpl *tmpl);
+extern int siw_hal_xfer_tmpl_add(struct device *dev, struct siw_hal_xfer_tmpl *tmpl,
+				u32 addr, int rd);
+extern int siw_hal_xfer_tmpl_run(struct device *dev, struct siw_hal_xfer_tmpl *tmpl,
+				struct siw_hal_xfer_io *io, int cnt);
+
 extern int siw_hal_ic_test_unit(struct device *dev, u32 data);
 
 extern struct siw_touch_operations *siw_hal_get_default_ops(int opt);
@@ -19,6 +19,14 @@
 #include <linux/module.h>
 #include <linux/moduleparam.h>
 #include <linux/kthread.h>
+#include <linux/wait.h>
+#include <linux/vmalloc.h>
+#include <linux/mm.h>
+#include <linux/fs.h>
+#include <linux/poll.h>
+#include <linux/log2.h>
+#include <linux/miscdevice.h>
+#include <asm/uaccess.h>
 #include <linux/sched.h>
 
 /* */
@@ -133,6 +141,55 @@ struct siw_abt_send_data {
 	u8 data[SIW_ABT_COMM_SEND_DATA_SZ];
 };
 
+/*
+ * Frame queue between the irq thread and the sender thread
+ * Single producer(irq) / single consumer(sender), never blocks the producer
+ */
+enum {
+	SIW_ABT_FRAME_QUEUE_SZ = 16,	/* power of 2 */
+};
+
+/*
+ * Frame header for latency analysis, prepended to each captured frame
+ * (the PC tool keeps getting the legacy siw_abt_send_data only)
+ *
+ * seq advances on every ABT irq, so frames lost anywhere leave a gap.
+ * Counters are cumulative since the capture start.
+ */
+enum {
+	SIW_ABT_FRAME_HDR_VER = 1,
+};
+
+struct siw_abt_frame_hdr {
+	u16 version;
+	u16 size;		/* sizeof(struct siw_abt_frame_hdr) */
+	u32 seq;
+	u64 ts_ns;		/* ktime_get() at snapshot */
+	u64 irq_ns;		/* ktime_get() at hard irq edge */
+	u32 overrun;	/* dropped, frame queue full */
+	u32 rd_short;	/* no or truncated debug data */
+	u32 rd_fail;	/* bus read failed */
+	u32 len;		/* siw_abt_send_data following */
+} __packed;
+
+struct siw_abt_frame_slot {
+	u32 len;
+	struct siw_abt_frame_hdr hdr;
+	struct siw_abt_send_data data;
+};
+
+struct siw_abt_frame_queue {
+	struct siw_abt_frame_slot *slot;
+	u32 head;
+	u32 tail;
+	u32 queued;
+	u32 sent;
+	u32 overrun;
+	wait_queue_head_t wq;
+	struct task_struct *thread;
+	struct mutex lock;	/* consumer side, one slot at a time */
+};
+
 struct siw_abt_dbg_report_hdr {
 	u8 key_frame;
 	u8 type;
@@ -305,6 +362,77 @@ struct siw_hal_abt_report_p {
 	u8 dummy[16];
 };
 
+/*
+ * Local capture
+ *
+ * /dev/{dev name}-abt exposes a vmalloc ring of the same frames
+ * sent to the PC tool, for rigs without network.
+ *
+ * mmap layout
+ * [0, PAGE_SIZE)             : struct siw_abt_cap_ctrl
+ * [PAGE_SIZE, + data_size)   : records
+ *
+ * Each record is a u32 length followed by a struct siw_abt_frame_hdr
+ * and a struct siw_abt_send_data, the length covering both,
+ * padded to 8 bytes. SIW_ABT_CAP_REC_PAD as length
+ * means the rest of the ring is unused and the next record is at 0.
+ * head/tail are free running byte counts, the kernel only moves head
+ * and the logger moves tail after consuming records.
+ * The page is writable from user space, so head, frames and dropped
+ * are kept in struct siw_abt_cap and only published to it.
+ * A frame not fitting into the free space is dropped, never blocking.
+ *
+ * ioctl
+ * SIW_ABT_CAP_IOC_START : start capture, struct siw_abt_cap_cfg
+ * SIW_ABT_CAP_IOC_STOP  : stop capture (also done on release)
+ */
+enum {
+	SIW_ABT_CAP_MAGIC		= 0x50414341,	/* "ACAP" */
+	SIW_ABT_CAP_VER			= 2,
+	SIW_ABT_CAP_REC_ALIGN	= 8,
+	SIW_ABT_CAP_REC_PAD		= 0xFFFFFFFF,
+};
+
+struct siw_abt_cap_ctrl {
+	u32 magic;
+	u32 version;
+	u32 data_offset;
+	u32 data_size;
+	u32 head;
+	u32 tail;
+	u32 frames;
+	u32 dropped;
+	struct siw_hal_abt_log_file_head file_head;
+} __packed;
+
+struct siw_abt_cap_cfg {
+	u32 mode;
+	u32 point;
+	u32 ocd;
+} __packed;
+
+#define SIW_ABT_CAP_IOC_MAGIC	'A'
+#define SIW_ABT_CAP_IOC_START	_IOW(SIW_ABT_CAP_IOC_MAGIC, 0x01, struct siw_abt_cap_cfg)
+#define SIW_ABT_CAP_IOC_STOP	_IO(SIW_ABT_CAP_IOC_MAGIC, 0x02)
+
+struct siw_abt_cap {
+	struct miscdevice misc;
+	char name[128];
+	void *abt;
+	struct mutex lock;
+	wait_queue_head_t wq;
+	void *buf;
+	struct siw_abt_cap_ctrl *ctrl;
+	u8 *data;
+	u32 size;
+	/* kernel copies, see siw_abt_cap_ctrl */
+	u32 head;
+	u32 frames;
+	u32 dropped;
+	int users;
+	int on;
+};
+
 struct siw_hal_abt_data {
 	struct device *dev;
 	char name[128];
@@ -321,7 +449,9 @@ struct siw_hal_abt_data {
 	u32 ocd_pieces_cnt;
 	int ocd_piece_size;
 
-	u16 frame_num;
+	u32 frame_seq;
+	u32 rd_short;
+	u32 rd_fail;
 	int abt_report_mode;
 	u8 abt_report_point;
 	u8 abt_report_ocd;
@@ -334,6 +464,22 @@ struct siw_hal_abt_data {
 	int client_connect_trying;
 
 	u32 connect_error_count;
+	int send_err;		/* sender gave up, teardown pending */
+	struct work_struct send_err_work;
+
+	/* chained irq reads (touch_xfer_allowed) */
+	struct siw_hal_xfer_tmpl irq_tmpl;
+	struct siw_hal_xfer_tmpl dbg_tmpl;
+	int xfer_ready;
+
+	/* debug buffer read piece, see abt_rd_cfg_table */
+	int dbg_rd_max;
+
+	/* irq -> sender thread */
+	struct siw_abt_frame_queue fq;
+
+	/* sender thread -> local capture */
+	struct siw_abt_cap cap;
 };
 
 enum {
@@ -392,6 +538,15 @@ module_param_named(s_abt_port_send, t_abt_port_send, uint, S_IRUGO|S_IWUSR|S_IWG
  */
 module_param_named(s_abt_buf_omk, t_abt_buf_omk, uint, S_IRUGO|S_IWUSR|S_IWGRP);
 
+static u32 t_abt_cap_size_mb = 8;
+
+/* usage
+ * (1) echo <value> > /sys/module/{Siw Touch Module Name}/parameters/s_abt_cap_size_mb
+ * (2) insmod {Siw Touch Module Name}.ko s_abt_cap_size_mb=<value>
+ * Applied on the next open of the capture device
+ */
+module_param_named(s_abt_cap_size_mb, t_abt_cap_size_mb, uint, S_IRUGO|S_IWUSR|S_IWGRP);
+
 
 static const char *abt_conn_name_str[] = {
 	[ABT_CONN_NOTHING]	= "CONN_NOTHING",
@@ -793,13 +948,70 @@ static void __used abt_set_data_func(struct siw_hal_abt_data *abt, u8 mode)
 	t_abt_dbg_base(abt, "set_get_data_func = %d\n", mode);
 }
 
+/*
+ * Debug buffer read granularity
+ *
+ * The chips listed here can't auto-increment data_i2cbase_addr
+ * beyond MAX_RW_SIZE, so the debug data is fetched in pieces,
+ * each one preceded by its serial_data_offset write.
+ * Others take the whole debug data in one burst,
+ * as large as the bus buffer allows.
+ */
+struct siw_hal_abt_rd_cfg {
+	int chip_type;
+	int rd_max;
+};
+
+static const struct siw_hal_abt_rd_cfg abt_rd_cfg_table[] = {
+	{ CHIP_LG4894, MAX_RW_SIZE },
+	{ CHIP_LG4895, MAX_RW_SIZE },
+	{ CHIP_LG4946, MAX_RW_SIZE },
+	{ CHIP_SW1828, MAX_RW_SIZE },
+	{ CHIP_NONE, 0 },
+};
+
+static int abt_dbg_rd_max(struct siw_hal_abt_data *abt)
+{
+	struct device *dev = abt->dev;
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	const struct siw_hal_abt_rd_cfg *cfg = abt_rd_cfg_table;
+	int rd_max;
+
+	if (abt->dbg_rd_max)
+		return abt->dbg_rd_max;
+
+	/* bus buffer minus the largest header, in words */
+	rd_max = touch_get_act_buf_size(ts) - SIW_TOUCH_XFER_HDR_SZ;
+	rd_max = min(rd_max, (int)SIW_ABT_COMM_SEND_DATA_SZ) & ~0x3;
+
+	while (cfg->chip_type != CHIP_NONE) {
+		if (cfg->chip_type == touch_chip_type(ts)) {
+			rd_max = min(rd_max, cfg->rd_max);
+			break;
+		}
+		cfg++;
+	}
+
+	/* not ready yet, stay on the safe side without caching */
+	if (rd_max < MAX_RW_SIZE)
+		return min_t(int, MAX_RW_SIZE, max(rd_max, 4));
+
+	abt->dbg_rd_max = rd_max;
+
+	t_abt_dbg_base(abt, "debug read piece %d\n", rd_max);
+
+	return rd_max;
+}
+
 static int abt_read_memory(struct siw_hal_abt_data *abt,
 			u32 raddr, u32 waddr,
 			u32 wdata, int wsize,
 			u8 *rdata, int rsize)
 {
 	struct device *dev = abt->dev;
-	u16 curr_read = 0;
+	int rd_max = abt_dbg_rd_max(abt);
+	u32 curr_read = 0;
 	u32 rest_read = rsize;
 	int ret = 0;
 
@@ -811,7 +1023,7 @@ static int abt_read_memory(struct siw_hal_abt_data *abt,
 	}
 #endif
 
-	curr_read = (rest_read > MAX_RW_SIZE) ? MAX_RW_SIZE : rest_read;
+	curr_read = min_t(u32, rest_read, rd_max);
 
 	while (curr_read > 0) {
 		ret = siw_hal_reg_write(dev, waddr, (void *)&wdata, wsize);
@@ -832,7 +1044,7 @@ static int abt_read_memory(struct siw_hal_abt_data *abt,
 		}
 		wdata += curr_read>>2;
 
-		curr_read = (rest_read > MAX_RW_SIZE) ? MAX_RW_SIZE : rest_read;
+		curr_read = min_t(u32, rest_read, rd_max);
 	}
 
 	return rsize;
@@ -1146,6 +1358,7 @@ static void abt_ksocket_exit_kill(struct siw_hal_abt_data *abt)
 		abt_comm->sock_send = NULL;
 		t_abt_dbg_base(abt, "sock_send released\n");
 	}
+	abt_comm->send_connected = 0;
 
 	abt_comm->curr_sock = NULL;
 	abt_comm->curr_addr = NULL;
@@ -1157,10 +1370,16 @@ static void abt_ksocket_exit_kill(struct siw_hal_abt_data *abt)
 	mutex_unlock(&abt->abt_comm_lock);
 }
 
+static void abt_frame_drain(struct siw_hal_abt_data *abt);
+
 static void abt_ksocket_exit(struct siw_hal_abt_data *abt)
 {
 	t_abt_dbg_base(abt, "start killing thread[%d]\n", abt->abt_conn_tool);
 
+	/* no new send, wait for the one in flight before sock_send goes */
+	abt_set_data_func(abt, 0);
+	abt_frame_drain(abt);
+
 	abt_ksocket_exit_disconn(abt);
 
 	t_abt_dbg_base(abt, "waiting for killing thread\n");
@@ -1173,6 +1392,12 @@ static void abt_ksocket_exit(struct siw_hal_abt_data *abt)
 }
 
 
+/*
+ * Called by the sender thread only (fq->lock held)
+ *
+ * The sender doesn't tear the connection down by itself,
+ * it flags the error and leaves it to send_err_work.
+ */
 static int32_t abt_ksocket_raw_data_send(
 		struct siw_hal_abt_data *abt, uint8_t *buf, uint32_t len)
 {
@@ -1180,6 +1405,9 @@ static int32_t abt_ksocket_raw_data_send(
 	struct siw_hal_abt_comm *abt_comm = &abt->abt_comm;
 	int ret = 0;
 
+	if (abt->send_err)
+		return -EPIPE;
+
 	if (abt_comm->send_connected == 0)
 		abt_ksocket_init_send_socket(abt);
 
@@ -1192,14 +1420,227 @@ static int32_t abt_ksocket_raw_data_send(
 		abt->connect_error_count++;
 		if (abt->connect_error_count > 10) {
 			t_abt_err(abt, "connection error - socket release\n");
-			abt_force_set_report_mode(abt, 0);
-			abt_ksocket_exit(abt);
+			abt->send_err = 1;
+			schedule_work(&abt->send_err_work);
+			ret = -ENOTCONN;
 		}
 	}
 
 	return ret;
 }
 
+/*
+ * Returns the slot to be filled by the irq thread,
+ * NULL if the sender thread hasn't caught up yet.
+ */
+static struct siw_abt_frame_slot *abt_frame_get(struct siw_hal_abt_data *abt)
+{
+	struct siw_abt_frame_queue *fq = &abt->fq;
+	u32 head = fq->head;
+
+	if ((head - READ_ONCE(fq->tail)) >= SIW_ABT_FRAME_QUEUE_SZ) {
+		fq->overrun++;
+		return NULL;
+	}
+
+	return &fq->slot[head & (SIW_ABT_FRAME_QUEUE_SZ - 1)];
+}
+
+static void abt_frame_put(struct siw_hal_abt_data *abt, u32 len)
+{
+	struct siw_abt_frame_queue *fq = &abt->fq;
+	u32 head = fq->head;
+
+	fq->slot[head & (SIW_ABT_FRAME_QUEUE_SZ - 1)].len = len;
+	fq->queued++;
+
+	/* slot contents before head */
+	smp_wmb();
+	WRITE_ONCE(fq->head, head + 1);
+
+	wake_up(&fq->wq);
+}
+
+/*
+ * Called by the sender thread only
+ */
+static void abt_cap_put(struct siw_hal_abt_data *abt,
+			struct siw_abt_frame_slot *slot)
+{
+	struct siw_abt_cap *cap = &abt->cap;
+	struct siw_abt_cap_ctrl *ctrl;
+	u32 len = sizeof(slot->hdr) + slot->len;
+	u32 size, head, used, offs, rec, pad;
+
+	mutex_lock(&cap->lock);
+
+	ctrl = cap->ctrl;
+	if (!cap->on || !ctrl)
+		goto out;
+
+	size = cap->size;
+	head = cap->head;
+	used = head - READ_ONCE(ctrl->tail);
+	offs = head & (size - 1);
+	rec = ALIGN(sizeof(u32) + len, SIW_ABT_CAP_REC_ALIGN);
+	pad = ((offs + rec) > size) ? (size - offs) : 0;
+
+	/* used > size : broken tail from user, hold until it's fixed */
+	if ((used > size) || ((used + pad + rec) > size)) {
+		cap->dropped++;
+		WRITE_ONCE(ctrl->dropped, cap->dropped);
+		goto out;
+	}
+
+	if (pad) {
+		*(u32 *)&cap->data[offs] = SIW_ABT_CAP_REC_PAD;
+		offs = 0;
+	}
+
+	*(u32 *)&cap->data[offs] = len;
+	offs += sizeof(u32);
+	memcpy(&cap->data[offs], &slot->hdr, sizeof(slot->hdr));
+	offs += sizeof(slot->hdr);
+	memcpy(&cap->data[offs], &slot->data, slot->len);
+	cap->frames++;
+	cap->head = head + pad + rec;
+
+	/* record before head */
+	smp_wmb();
+	WRITE_ONCE(ctrl->frames, cap->frames);
+	WRITE_ONCE(ctrl->head, cap->head);
+
+	wake_up_interruptible(&cap->wq);
+
+out:
+	mutex_unlock(&cap->lock);
+}
+
+static int abt_frame_pending(struct siw_abt_frame_queue *fq)
+{
+	return (READ_ONCE(fq->head) != fq->tail);
+}
+
+static int abt_frame_sender(void *data)
+{
+	struct siw_hal_abt_data *abt = (struct siw_hal_abt_data *)data;
+	struct siw_abt_frame_queue *fq = &abt->fq;
+	struct siw_abt_frame_slot *slot;
+
+	while (!kthread_should_stop()) {
+		wait_event_interruptible(fq->wq,
+			abt_frame_pending(fq) || kthread_should_stop());
+
+		/* drain everything queued since the last wake-up */
+		while (1) {
+			mutex_lock(&fq->lock);
+			if (!abt_frame_pending(fq)) {
+				mutex_unlock(&fq->lock);
+				break;
+			}
+
+			/* head before slot contents */
+			smp_rmb();
+
+			slot = &fq->slot[fq->tail & (SIW_ABT_FRAME_QUEUE_SZ - 1)];
+
+			/* tool may have gone away while the frame was queued */
+			if (READ_ONCE(abt->cap.on)) {
+				abt_cap_put(abt, slot);
+				fq->sent++;
+			} else if (abt_is_set_func(abt)) {
+				abt_ksocket_raw_data_send(abt,
+					(u8 *)&slot->data, slot->len);
+				fq->sent++;
+			}
+
+			/* slot contents consumed before tail */
+			smp_mb();
+			WRITE_ONCE(fq->tail, fq->tail + 1);
+			mutex_unlock(&fq->lock);
+
+			if (kthread_should_stop())
+				break;
+		}
+	}
+
+	return 0;
+}
+
+static int abt_frame_queue_init(struct siw_hal_abt_data *abt)
+{
+	struct siw_abt_frame_queue *fq = &abt->fq;
+	struct task_struct *thread;
+
+	fq->slot = vzalloc(sizeof(*fq->slot) * SIW_ABT_FRAME_QUEUE_SZ);
+	if (!fq->slot) {
+		t_abt_err(abt, "failed to allocate frame queue\n");
+		return -ENOMEM;
+	}
+
+	init_waitqueue_head(&fq->wq);
+	mutex_init(&fq->lock);
+
+	thread = kthread_run(abt_frame_sender, abt, "%s-tx", abt->name);
+	if (IS_ERR(thread)) {
+		t_abt_err(abt, "unable to start sender thread\n");
+		mutex_destroy(&fq->lock);
+		vfree(fq->slot);
+		fq->slot = NULL;
+		return PTR_ERR(thread);
+	}
+	fq->thread = thread;
+
+	return 0;
+}
+
+static void abt_frame_sender_park(struct siw_hal_abt_data *abt)
+{
+	struct siw_abt_frame_queue *fq = &abt->fq;
+
+	if (fq->thread) {
+		kthread_stop(fq->thread);
+		fq->thread = NULL;
+	}
+}
+
+/*
+ * The irq side has to be stopped before, see siw_hal_abt_free
+ */
+static void abt_frame_queue_free(struct siw_hal_abt_data *abt)
+{
+	struct siw_abt_frame_queue *fq = &abt->fq;
+
+	if (!fq->slot)
+		return;
+
+	abt_frame_sender_park(abt);
+	mutex_destroy(&fq->lock);
+
+	if (fq->overrun) {
+		t_abt_info(abt, "frame queue: queued %d, sent %d, overrun %d\n",
+			fq->queued, fq->sent, fq->overrun);
+	}
+
+	vfree(fq->slot);
+	fq->slot = NULL;
+}
+
+/*
+ * Waits for the frame in flight and drops the queued ones
+ */
+static void abt_frame_drain(struct siw_hal_abt_data *abt)
+{
+	struct siw_abt_frame_queue *fq = &abt->fq;
+
+	if (!fq->thread)
+		return;
+
+	mutex_lock(&fq->lock);
+	WRITE_ONCE(fq->tail, READ_ONCE(fq->head));
+	mutex_unlock(&fq->lock);
+}
+
 static int abt_ksocket_recv_err(struct siw_hal_abt_data *abt,
 				struct siw_abt_comm_packet *recv_pkt,
 				uint32_t len)
@@ -1647,6 +2088,9 @@ static int abt_ksocket_init(struct siw_hal_abt_data *abt,
 
 	abt->abt_socket_report_mode = 1;
 
+	abt->connect_error_count = 0;
+	abt->send_err = 0;
+
 	memcpy(abt_comm->send_ip, ip, ABT_SEND_IP_SIZE);
 
 	switch(abt->abt_conn_tool) {
@@ -1731,6 +2175,14 @@ static ssize_t abt_show_tool_t(struct device *dev, char *buf)
 						"mode:%d, ip:%s\n",
 						mode, abt_comm->send_ip);
 
+	size += siw_snprintf(buf, size,
+						"queued:%d, sent:%d, overrun:%d\n",
+						abt->fq.queued, abt->fq.sent, abt->fq.overrun);
+
+	size += siw_snprintf(buf, size,
+						"seq:%d, rd_short:%d, rd_fail:%d\n",
+						abt->frame_seq, abt->rd_short, abt->rd_fail);
+
 out:
 	t_abt_info(abt, "read raw report mode - mode:%d ip:%s\n",
 		mode, abt_comm->send_ip);
@@ -1786,6 +2238,11 @@ static int abt_store_tool_touch(struct siw_hal_abt_data *abt, char *ip)
 {
 	int ret = 0;
 
+	if (abt->cap.on) {
+		t_abt_err(abt, "local capture is running\n");
+		return -EBUSY;
+	}
+
 	ret = abt_tool_start(abt, ip,
 				ABT_CONN_TOUCH, abt_ksocket_recv_from_pctool);
 
@@ -1822,7 +2279,9 @@ static int abt_store_tool_exit_chk(struct siw_hal_abt_data *abt)
 
 static int abt_store_tool_exit(struct siw_hal_abt_data *abt, char *ip)
 {
-//	struct device *dev = abt->dev;
+	struct device *dev = abt->dev;
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
 
 	mutex_lock(&abt->abt_comm_lock);
 	if (!abt_store_tool_exit_chk(abt)) {
@@ -1832,14 +2291,32 @@ static int abt_store_tool_exit(struct siw_hal_abt_data *abt, char *ip)
 	mutex_unlock(&abt->abt_comm_lock);
 
 	abt_ksocket_exit(abt);
-	abt_set_data_func(abt, 0);
 
+	/* the irq handler reads abt_report_mode under ts->lock */
+	mutex_lock(&ts->lock);
 	mutex_lock(&abt->abt_comm_lock);
 	abt_set_report_mode(abt, 0);
 	mutex_unlock(&abt->abt_comm_lock);
+	mutex_unlock(&ts->lock);
 	return 0;
 }
 
+/*
+ * Control side of the sender's connection error
+ */
+static void abt_send_err_work_func(struct work_struct *work)
+{
+	struct siw_hal_abt_data *abt =
+			container_of(work, struct siw_hal_abt_data, send_err_work);
+
+	mutex_lock(&abt->abt_socket_lock);
+	if (abt->send_err) {
+		t_abt_info(abt, "tool exit on send error\n");
+		abt_store_tool_exit(abt, NULL);
+	}
+	mutex_unlock(&abt->abt_socket_lock);
+}
+
 static ssize_t __abt_store_tool(struct device *dev,
 				const char *buf, size_t count, int opt)
 {
@@ -1882,6 +2359,8 @@ static ssize_t __abt_store_tool(struct device *dev,
 		"set raw report mode - mode:%d, IP:%s\n",
 		mode, ip);
 
+	/* against send_err_work */
+	mutex_lock(&abt->abt_socket_lock);
 	switch (mode) {
 	case STORE_ABT_MODE_STUDIO:
 		t_abt_info(abt, "Not supperted\n");
@@ -1895,6 +2374,7 @@ static ssize_t __abt_store_tool(struct device *dev,
 		ret = abt_store_tool_exit(abt, ip);
 		break;
 	}
+	mutex_unlock(&abt->abt_socket_lock);
 
 	if (setFlag) {
 		mutex_lock(&abt->abt_comm_lock);
@@ -1929,7 +2409,131 @@ static ssize_t abt_store_tool_t(struct device *dev,
 	return __abt_store_tool(dev, buf, count, 1);
 }
 
-static void __used siw_hal_abt_report_mode(struct device *dev, u8 *all_data)
+enum {
+	ABT_DBG_XFER_PAIRS	= (SIW_TOUCH_MAX_XFER_COUNT>>1),
+	/* OCD block reported after the debug data */
+	ABT_OCD_DATA_SZ		= 112,
+	/* room left in a frame after the debug header, OCD and touch data */
+	ABT_DBG_DATA_MAX	= (SIW_ABT_COMM_SEND_DATA_SZ
+						- sizeof(struct siw_abt_dbg_report_hdr)
+						- ABT_OCD_DATA_SZ
+						- (sizeof(struct siw_hal_touch_data) * MAX_FINGER)),
+};
+
+/*
+ * irq_tmpl : status/touch data, debug offset, debug header
+ * dbg_tmpl : (debug offset, debug data) x ABT_DBG_XFER_PAIRS
+ */
+static int abt_xfer_tmpl_setup(struct siw_hal_abt_data *abt)
+{
+	struct device *dev = abt->dev;
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_hal_reg *reg = chip->reg;
+	int i;
+	int ret = 0;
+
+	if (abt->xfer_ready) {
+		return (abt->xfer_ready > 0) ? 0 : -EINVAL;
+	}
+
+	abt->xfer_ready = -1;
+
+	if (!touch_xfer_allowed(chip->ts)) {
+		return -EINVAL;
+	}
+
+	siw_hal_xfer_tmpl_init(dev, &abt->irq_tmpl);
+	ret |= siw_hal_xfer_tmpl_add(dev, &abt->irq_tmpl, reg->tc_ic_status, 1);
+	ret |= siw_hal_xfer_tmpl_add(dev, &abt->irq_tmpl, reg->serial_data_offset, 0);
+	ret |= siw_hal_xfer_tmpl_add(dev, &abt->irq_tmpl, reg->data_i2cbase_addr, 1);
+
+	siw_hal_xfer_tmpl_init(dev, &abt->dbg_tmpl);
+	for (i = 0; i < ABT_DBG_XFER_PAIRS; i++) {
+		ret |= siw_hal_xfer_tmpl_add(dev, &abt->dbg_tmpl, reg->serial_data_offset, 0);
+		ret |= siw_hal_xfer_tmpl_add(dev, &abt->dbg_tmpl, reg->data_i2cbase_addr, 1);
+	}
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	abt->xfer_ready = 1;
+
+	return 0;
+}
+
+/*
+ * Status/touch data and the debug report header in one message
+ */
+static int abt_xfer_irq_read(struct siw_hal_abt_data *abt,
+			u8 *all_data, int size, u8 *d_header, int d_header_size)
+{
+	struct siw_hal_xfer_io io[3];
+	u32 dbg_offset = abt->dbg_offset_base;
+
+	io[0].buf = all_data;
+	io[0].size = size;
+	io[1].buf = &dbg_offset;
+	io[1].size = sizeof(u32);
+	io[2].buf = d_header;
+	io[2].size = d_header_size;
+
+	return siw_hal_xfer_tmpl_run(abt->dev, &abt->irq_tmpl, io, 3);
+}
+
+/*
+ * Debug data in abt_dbg_rd_max() pieces,
+ * up to ABT_DBG_XFER_PAIRS pieces per message within the xfer pool
+ */
+static int abt_xfer_dbg_read(struct siw_hal_abt_data *abt,
+			u32 dbg_offset, u8 *rdata, int rsize)
+{
+	struct siw_touch_chip *chip = to_touch_chip(abt->dev);
+	struct siw_ts *ts = chip->ts;
+	struct siw_hal_xfer_io io[ABT_DBG_XFER_PAIRS<<1];
+	u32 offs[ABT_DBG_XFER_PAIRS];
+	int rd_max = abt_dbg_rd_max(abt);
+	int pool;
+	int curr;
+	int cnt;
+	int ret = 0;
+
+	while (rsize > 0) {
+		pool = touch_get_act_buf_size(ts);
+		for (cnt = 0; (cnt < ABT_DBG_XFER_PAIRS) && (rsize > 0); cnt++) {
+			curr = min(rsize, rd_max);
+
+			pool -= L1_CACHE_ALIGN(sizeof(u32)) + L1_CACHE_ALIGN(curr);
+			if (cnt && (pool < 0))
+				break;
+
+			offs[cnt] = dbg_offset;
+			io[cnt<<1].buf = &offs[cnt];
+			io[cnt<<1].size = sizeof(u32);
+			io[(cnt<<1) + 1].buf = rdata;
+			io[(cnt<<1) + 1].size = curr;
+
+			rdata += curr;
+			rsize -= curr;
+			dbg_offset += curr>>2;
+		}
+
+		ret = siw_hal_xfer_tmpl_run(abt->dev, &abt->dbg_tmpl, io, cnt<<1);
+		if (ret < 0) {
+			break;
+		}
+	}
+
+	return ret;
+}
+
+/*
+ * slot NULL : frame queue full, the frame is built in data_send
+ * to keep the chip side going, then dropped
+ */
+static void __used siw_hal_abt_report_mode(struct device *dev, u8 *all_data,
+					struct siw_abt_frame_slot *slot,
+					int hdr_ready)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
 	struct siw_ts *ts = chip->ts;
@@ -1939,16 +2543,18 @@ static void __used siw_hal_abt_report_mode(struct device *dev, u8 *all_data)
 	struct siw_abt_send_data *packet_ptr = NULL;
 	struct siw_abt_dbg_report_hdr *d_header = NULL;
 	struct siw_hal_touch_info *t_info = NULL;
-	struct timeval t_stamp;
+	ktime_t t_stamp = ktime_get();
 	u32 rst_offset_val;
 	u32 dbg_offset;
 	u8 *d_data_ptr;
 	int d_header_size;
-	int i;
+	int data_size;
 	int ret = 0;
 
-	packet_ptr = abt_comm->data_send;
-	d_header = (struct siw_abt_dbg_report_hdr *)(abt_comm->data_send->data);
+	abt->frame_seq++;
+
+	packet_ptr = (slot) ? &slot->data : abt_comm->data_send;
+	d_header = (struct siw_abt_dbg_report_hdr *)(packet_ptr->data);
 	d_header_size = sizeof(struct siw_abt_dbg_report_hdr);
 	t_info = (struct siw_hal_touch_info *)all_data;
 	rst_offset_val = 1;
@@ -1956,13 +2562,14 @@ static void __used siw_hal_abt_report_mode(struct device *dev, u8 *all_data)
 	d_data_ptr = (u8 *)d_header + d_header_size;
 
 	if (abt->abt_report_mode) {
-		ret = abt_read_memory(abt,
-				reg->data_i2cbase_addr,
-				reg->serial_data_offset,
-				dbg_offset,
-				(int)sizeof(u32),
-				(u8 *)d_header,
-				d_header_size);
+		if (!hdr_ready)
+			ret = abt_read_memory(abt,
+					reg->data_i2cbase_addr,
+					reg->serial_data_offset,
+					dbg_offset,
+					(int)sizeof(u32),
+					(u8 *)d_header,
+					d_header_size);
 		if (ret < 0) {
 			t_abt_err(abt,
 					"Report reg addr read failed(%d, %d), %d\n",
@@ -1972,51 +2579,42 @@ static void __used siw_hal_abt_report_mode(struct device *dev, u8 *all_data)
 		}
 
 		dbg_offset	+= (d_header_size>>2);
-		if (d_header->type == abt->abt_report_mode) {
-			for (i = 0; i < d_header->data_size>>MAX_RW_SIZE_POW; i++) {
-				ret = abt_read_memory(abt,
-						reg->data_i2cbase_addr,
-						reg->serial_data_offset,
-						dbg_offset,
-						(int)sizeof(u32),
-						d_data_ptr,
-						sizeof(u8)<<MAX_RW_SIZE_POW);
-				if (ret < 0) {
-					t_abt_err(abt,
-							"Report reg addr read failed(%d, %d), %d\n",
-							dbg_offset,
-							(int)sizeof(u32),
-							ret);
-				}
-
-				d_data_ptr += (sizeof(u8)<<MAX_RW_SIZE_POW);
-				dbg_offset += (sizeof(u8)<<MAX_RW_SIZE_POW)>>2;
+		if (ret < 0) {
+			abt->rd_fail++;
+		} else if (d_header->type != abt->abt_report_mode) {
+			t_abt_err(abt, "debug data load error : type %d, size %d\n",
+					d_header->type, d_header->data_size);
+			abt->rd_short++;
+		} else {
+			data_size = d_header->data_size;
+			if (data_size > ABT_DBG_DATA_MAX) {
+				t_abt_err(abt, "debug data truncated : size %d\n",
+						data_size);
+				data_size = ABT_DBG_DATA_MAX;
+				abt->rd_short++;
 			}
 
-			if (d_header->data_size % MAX_RW_SIZE != 0) {
+			if (hdr_ready)
+				ret = abt_xfer_dbg_read(abt, dbg_offset,
+						d_data_ptr, data_size);
+			else
 				ret = abt_read_memory(abt,
 						reg->data_i2cbase_addr,
 						reg->serial_data_offset,
 						dbg_offset,
 						(int)sizeof(u32),
 						d_data_ptr,
-						sizeof(u8)*(d_header->data_size%MAX_RW_SIZE));
-				if (ret < 0) {
-					t_abt_err(abt,
-							"Report reg addr read failed(%d, %d), %d\n",
-							dbg_offset,
-							(int)sizeof(u32),
-							ret);
-				}
-
-				d_data_ptr += (sizeof(u8)*(d_header->data_size
-					% MAX_RW_SIZE));
-				dbg_offset += (sizeof(u8)*(d_header->data_size
-					% MAX_RW_SIZE)>>2);
+						data_size);
+			if (ret < 0) {
+				t_abt_err(abt,
+						"Report reg addr read failed(%d, %d), %d\n",
+						dbg_offset,
+						data_size,
+						ret);
+				abt->rd_fail++;
 			}
-		} else {
-			t_abt_err(abt, "debug data load error : type %d, size %d\n",
-					d_header->type, d_header->data_size);
+
+			d_data_ptr += data_size;
 		}
 		ret = siw_hal_reg_write(dev,
 					reg->tc_interrupt_status,
@@ -2027,8 +2625,8 @@ static void __used siw_hal_abt_report_mode(struct device *dev, u8 *all_data)
 	/* ABS0 */
 	if (t_info->wakeup_type == 0) {
 		if (abt->abt_report_ocd) {
-			memcpy(d_data_ptr, &all_data[36<<2], sizeof(u8) * 112);
-			d_data_ptr += (sizeof(u8) * 112);
+			memcpy(d_data_ptr, &all_data[36<<2], ABT_OCD_DATA_SZ);
+			d_data_ptr += ABT_OCD_DATA_SZ;
 		}
 
 		if (t_info->data[0].track_id != 15) {
@@ -2045,14 +2643,11 @@ static void __used siw_hal_abt_report_mode(struct device *dev, u8 *all_data)
 
 
 	if (((u8 *)d_data_ptr) - ((u8 *)packet_ptr) > 0) {
-		do_gettimeofday(&t_stamp);
-
-		abt->frame_num++;
 		packet_ptr->type = DEBUG_DATA;
 		packet_ptr->mode = abt->abt_report_mode;
-		packet_ptr->frame_num = abt->frame_num;
-		packet_ptr->timestamp =
-			t_stamp.tv_sec * 1000000 + t_stamp.tv_usec;
+		packet_ptr->frame_num = abt->frame_seq;
+		/* legacy field, monotonic but still wraps in u32 us */
+		packet_ptr->timestamp = (u32)ktime_to_us(t_stamp);
 
 		packet_ptr->flag = 0;
 		if (abt->abt_report_point)
@@ -2060,8 +2655,21 @@ static void __used siw_hal_abt_report_mode(struct device *dev, u8 *all_data)
 		if (abt->abt_report_ocd)
 			packet_ptr->flag |= (0x1)<<1;
 
-		abt_ksocket_raw_data_send(abt, (u8 *)packet_ptr,
-				(u8 *)d_data_ptr - (u8 *)packet_ptr);
+		if (slot) {
+			struct siw_abt_frame_hdr *fhdr = &slot->hdr;
+
+			fhdr->version = SIW_ABT_FRAME_HDR_VER;
+			fhdr->size = sizeof(*fhdr);
+			fhdr->seq = abt->frame_seq;
+			fhdr->ts_ns = ktime_to_ns(t_stamp);
+			fhdr->irq_ns = ktime_to_ns(ts->irq_ktime);
+			fhdr->overrun = abt->fq.overrun;
+			fhdr->rd_short = abt->rd_short;
+			fhdr->rd_fail = abt->rd_fail;
+			fhdr->len = (u8 *)d_data_ptr - (u8 *)packet_ptr;
+
+			abt_frame_put(abt, fhdr->len);
+		}
 	}
 }
 
@@ -2071,8 +2679,11 @@ static int siw_hal_abt_irq_handler(struct device *dev)
 	struct siw_ts *ts = chip->ts;
 	struct siw_hal_reg *reg = chip->reg;
 	struct siw_hal_abt_data *abt = (struct siw_hal_abt_data *)ts->abt;
+	struct siw_abt_frame_slot *slot = NULL;
+	u8 *d_header = NULL;
 	u8 all_data[264];
 	int report_mode = abt_is_set_func(abt);
+	int hdr_ready = 0;
 	int ret = 0;
 
 	if (atomic_read(&chip->init) == IC_INIT_NEED) {
@@ -2083,17 +2694,40 @@ static int siw_hal_abt_irq_handler(struct device *dev)
 #if defined(__SIW_SUPPORT_PM_QOS)
 	pm_qos_update_request(&chip->pm_qos_req, 10);
 #endif
-	ret = siw_hal_reg_read(dev,
-				reg->tc_ic_status,
-			    (void *)all_data, sizeof(all_data));
+	if (report_mode) {
+		/*
+		 * The debug buffer still has to be read and released
+		 * when the queue is full, so fall back to the scratch frame.
+		 */
+		slot = abt_frame_get(abt);
+		d_header = (slot) ? slot->data.data : abt->abt_comm.data_send->data;
+	}
+
+	if (report_mode && abt->abt_report_mode &&
+		(abt_xfer_tmpl_setup(abt) >= 0)) {
+		ret = abt_xfer_irq_read(abt, all_data, sizeof(all_data),
+				d_header,
+				sizeof(struct siw_abt_dbg_report_hdr));
+		hdr_ready = (ret >= 0);
+	} else {
+		ret = siw_hal_reg_read(dev,
+					reg->tc_ic_status,
+				    (void *)all_data, sizeof(all_data));
+	}
 #if defined(__SIW_SUPPORT_PM_QOS)
 	pm_qos_update_request(&chip->pm_qos_req, PM_QOS_DEFAULT_VALUE);
 #endif
 	if (ret < 0) {
+		if (report_mode) {
+			/* leave a gap in seq */
+			abt->frame_seq++;
+			abt->rd_fail++;
+		}
 		goto out;
 	}
 
 	memcpy(&chip->info, all_data, sizeof(chip->info));
+	chip->info_p = &chip->info;
 
 	ret = siw_ops_chk_status(ts);
 	if (ret < 0) {
@@ -2101,16 +2735,16 @@ static int siw_hal_abt_irq_handler(struct device *dev)
 	}
 
 	if (report_mode) {
-		if (chip->info.wakeup_type == ABS_MODE)
+		if (chip->info_p->wakeup_type == ABS_MODE)
 			ret = siw_ops_irq_abs(ts);
 		else
 			ret = siw_ops_irq_lpwg(ts);
 
-		siw_hal_abt_report_mode(dev, all_data);
+		siw_hal_abt_report_mode(dev, all_data, slot, hdr_ready);
 		goto out;
 	}
 
-	if (chip->info.wakeup_type == ABS_MODE) {
+	if (chip->info_p->wakeup_type == ABS_MODE) {
 		ret = siw_ops_irq_abs(ts);
 		goto out;
 	}
@@ -2127,6 +2761,263 @@ void siw_hal_switch_to_abt_irq_handler(struct siw_ts *ts)
 	t_dev_info(ts->dev, "set new irq handler for ABT\n");
 }
 
+static int abt_cap_start(struct siw_hal_abt_data *abt,
+			struct siw_abt_cap_cfg *cfg)
+{
+	struct device *dev = abt->dev;
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	struct siw_abt_cap *cap = &abt->cap;
+	int ret = 0;
+
+	if (atomic_read(&ts->state.debug_tool) != DEBUG_TOOL_ENABLE) {
+		t_abt_err(abt, "tool disabled\n");
+		return -EPERM;
+	}
+
+	if (cap->on) {
+		return -EALREADY;
+	}
+
+	/* one consumer at a time, the PC tool or the local capture */
+	if (abt->abt_comm.thread != NULL) {
+		t_abt_err(abt, "capture: PC tool is running\n");
+		return -EBUSY;
+	}
+
+	siw_touch_mon_pause(dev);
+
+	abt->abt_report_point = !!cfg->point;
+	abt->abt_report_ocd = !!cfg->ocd;
+
+	mutex_lock(&abt->abt_comm_lock);
+	ret = abt_set_report_mode(abt, cfg->mode);
+	mutex_unlock(&abt->abt_comm_lock);
+	if (ret < 0) {
+		siw_touch_mon_resume(dev);
+		return ret;
+	}
+
+	/*
+	 * counters in siw_abt_frame_hdr start over,
+	 * the irq handler updates them under ts->lock
+	 */
+	mutex_lock(&ts->lock);
+	abt->frame_seq = 0;
+	abt->rd_short = 0;
+	abt->rd_fail = 0;
+	abt->fq.overrun = 0;
+	mutex_unlock(&ts->lock);
+
+	mutex_lock(&cap->lock);
+	WRITE_ONCE(cap->on, 1);
+	mutex_unlock(&cap->lock);
+
+	abt_set_data_func(abt, 1);
+
+	t_abt_info(abt, "capture start: mode %d, point %d, ocd %d\n",
+		cfg->mode, abt->abt_report_point, abt->abt_report_ocd);
+
+	return 0;
+}
+
+static void abt_cap_stop(struct siw_hal_abt_data *abt)
+{
+	struct siw_abt_cap *cap = &abt->cap;
+
+	if (!cap->on) {
+		return;
+	}
+
+	abt_set_data_func(abt, 0);
+
+	mutex_lock(&cap->lock);
+	WRITE_ONCE(cap->on, 0);
+	mutex_unlock(&cap->lock);
+
+	mutex_lock(&abt->abt_comm_lock);
+	abt_set_report_mode(abt, 0);
+	mutex_unlock(&abt->abt_comm_lock);
+
+	siw_touch_mon_resume(abt->dev);
+
+	t_abt_info(abt, "capture stop: frames %d, dropped %d\n",
+		cap->frames, cap->dropped);
+}
+
+static void abt_cap_file_head(struct siw_hal_abt_data *abt,
+			struct siw_hal_abt_log_file_head *head)
+{
+	struct siw_touch_chip *chip = to_touch_chip(abt->dev);
+	struct siw_ts *ts = chip->ts;
+	struct touch_device_caps *caps = &ts->caps;
+
+	/* node layout is up to the logger, see the tool setting */
+	head->resolution_x = caps->max_x;
+	head->resolution_y = caps->max_y;
+	head->loc_x[0] = 0;
+	head->loc_x[1] = caps->max_x;
+	head->loc_y[0] = 0;
+	head->loc_y[1] = caps->max_y;
+}
+
+static int abt_cap_open(struct inode *inode, struct file *filp)
+{
+	struct miscdevice *misc = filp->private_data;
+	struct siw_abt_cap *cap = container_of(misc, struct siw_abt_cap, misc);
+	struct siw_hal_abt_data *abt = cap->abt;
+	u32 size;
+	int ret = 0;
+
+	mutex_lock(&cap->lock);
+
+	if (cap->users) {
+		ret = -EBUSY;
+		goto out;
+	}
+
+	size = roundup_pow_of_two(max_t(u32, t_abt_cap_size_mb, 1)<<20);
+
+	cap->buf = vmalloc_user(PAGE_SIZE + size);
+	if (!cap->buf) {
+		t_abt_err(abt, "capture: failed to allocate %d bytes\n", size);
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	cap->ctrl = cap->buf;
+	cap->data = (u8 *)cap->buf + PAGE_SIZE;
+	cap->size = size;
+	cap->head = 0;
+	cap->frames = 0;
+	cap->dropped = 0;
+
+	cap->ctrl->magic = SIW_ABT_CAP_MAGIC;
+	cap->ctrl->version = SIW_ABT_CAP_VER;
+	cap->ctrl->data_offset = PAGE_SIZE;
+	cap->ctrl->data_size = size;
+	abt_cap_file_head(abt, &cap->ctrl->file_head);
+
+	cap->users++;
+	filp->private_data = cap;
+
+out:
+	mutex_unlock(&cap->lock);
+
+	return ret;
+}
+
+static int abt_cap_release(struct inode *inode, struct file *filp)
+{
+	struct siw_abt_cap *cap = filp->private_data;
+	struct siw_hal_abt_data *abt = cap->abt;
+
+	abt_cap_stop(abt);
+
+	mutex_lock(&cap->lock);
+	vfree(cap->buf);
+	cap->buf = NULL;
+	cap->ctrl = NULL;
+	cap->data = NULL;
+	cap->users--;
+	mutex_unlock(&cap->lock);
+
+	return 0;
+}
+
+static long abt_cap_ioctl(struct file *filp,
+			unsigned int cmd, unsigned long arg)
+{
+	struct siw_abt_cap *cap = filp->private_data;
+	struct siw_hal_abt_data *abt = cap->abt;
+	struct siw_abt_cap_cfg cfg;
+
+	switch (cmd) {
+	case SIW_ABT_CAP_IOC_START:
+		if (copy_from_user(&cfg, (void __user *)arg, sizeof(cfg)))
+			return -EFAULT;
+		return abt_cap_start(abt, &cfg);
+	case SIW_ABT_CAP_IOC_STOP:
+		abt_cap_stop(abt);
+		return 0;
+	}
+
+	return -ENOTTY;
+}
+
+static int abt_cap_mmap(struct file *filp, struct vm_area_struct *vma)
+{
+	struct siw_abt_cap *cap = filp->private_data;
+
+	return remap_vmalloc_range(vma, cap->buf, vma->vm_pgoff);
+}
+
+static unsigned int abt_cap_poll(struct file *filp,
+			struct poll_table_struct *wait)
+{
+	struct siw_abt_cap *cap = filp->private_data;
+	struct siw_abt_cap_ctrl *ctrl = cap->ctrl;
+
+	poll_wait(filp, &cap->wq, wait);
+
+	if (READ_ONCE(cap->head) != READ_ONCE(ctrl->tail))
+		return POLLIN | POLLRDNORM;
+
+	return 0;
+}
+
+static const struct file_operations abt_cap_fops = {
+	.owner			= THIS_MODULE,
+	.open			= abt_cap_open,
+	.release		= abt_cap_release,
+	.unlocked_ioctl	= abt_cap_ioctl,
+	.mmap			= abt_cap_mmap,
+	.poll			= abt_cap_poll,
+	.llseek			= no_llseek,
+};
+
+static int abt_cap_init(struct siw_hal_abt_data *abt)
+{
+	struct siw_abt_cap *cap = &abt->cap;
+	struct miscdevice *misc = &cap->misc;
+	int ret;
+
+	mutex_init(&cap->lock);
+	init_waitqueue_head(&cap->wq);
+	cap->abt = abt;
+
+	snprintf(cap->name, sizeof(cap->name), "%s", abt->name);
+
+	misc->minor = MISC_DYNAMIC_MINOR;
+	misc->name = cap->name;
+	misc->fops = &abt_cap_fops;
+
+	ret = misc_register(misc);
+	if (ret < 0) {
+		t_abt_err(abt, "capture: misc_register failed, %d\n", ret);
+		mutex_destroy(&cap->lock);
+		cap->abt = NULL;
+		return ret;
+	}
+
+	t_abt_dbg_base(abt, "capture: /dev/%s\n", cap->name);
+
+	return 0;
+}
+
+static void abt_cap_free(struct siw_hal_abt_data *abt)
+{
+	struct siw_abt_cap *cap = &abt->cap;
+
+	if (cap->abt == NULL) {
+		return;
+	}
+
+	misc_deregister(&cap->misc);
+	mutex_destroy(&cap->lock);
+	cap->abt = NULL;
+}
+
 #if defined(__SIW_ATTR_PERMISSION_ALL)
 #define __TOUCH_ABT_PERM	(S_IRUGO | S_IWUGO)
 #else
@@ -2194,6 +3085,8 @@ static struct siw_hal_abt_data *siw_hal_abt_alloc(struct device *dev)
 	mutex_init(&abt->abt_socket_lock);
 	abt->abt_socket_mutex_flag = 1;
 
+	INIT_WORK(&abt->send_err_work, abt_send_err_work_func);
+
 	abt->prev_rnd_piece_no = DEF_RNDCPY_EVERY_NTH_FRAME;
 
 	abt->abt_conn_tool = ABT_CONN_NOTHING;
@@ -2214,13 +3107,21 @@ static struct siw_hal_abt_data *siw_hal_abt_alloc(struct device *dev)
 	abt->dbg_offset_base >>= 2;
 	abt->dbg_offset = abt->dbg_offset_base;
 
+	if (abt_frame_queue_init(abt) < 0)
+		goto out_frame_queue;
+
 	ts->abt = abt;
 
 	return abt;
 
-out_send_packet:
+out_frame_queue:
+	mutex_destroy(&abt->abt_comm_lock);
+	mutex_destroy(&abt->abt_socket_lock);
 	touch_kfree(dev, send_packet);
 
+out_send_packet:
+	touch_kfree(dev, data_send);
+
 out_data_send:
 	touch_kfree(dev, abt);
 
@@ -2237,7 +3138,20 @@ static void siw_hal_abt_free(struct device *dev)
 	if (abt) {
 		t_dev_dbg_base(dev, "free abt[%s]\n", abt->name);
 
+		mutex_lock(&abt->abt_socket_lock);
 		abt_store_tool_exit(abt, NULL);
+		mutex_unlock(&abt->abt_socket_lock);
+
+		/* no more frames from the irq thread (abt_frame_get) */
+		mutex_lock(&ts->lock);
+		abt_set_data_func(abt, 0);
+		mutex_unlock(&ts->lock);
+
+		/* the sender may still queue send_err_work until parked */
+		abt_frame_sender_park(abt);
+		cancel_work_sync(&abt->send_err_work);
+
+		abt_frame_queue_free(abt);
 
 		mutex_destroy(&abt->abt_comm_lock);
 		mutex_destroy(&abt->abt_socket_lock);
@@ -2286,6 +3200,9 @@ static int siw_hal_abt_create_sysfs(struct device *dev)
 	t_dev_dbg_base(dev, "%s abt sysfs registered\n",
 			touch_chip_name(ts));
 
+	/* local capture is optional */
+	abt_cap_init(abt);
+
 	return 0;
 
 out_sysfs:
@@ -2311,6 +3228,8 @@ static void siw_hal_abt_remove_sysfs(struct device *dev)
 		return;
 	}
 
+	abt_cap_free((struct siw_hal_abt_data *)ts->abt);
+
 	sysfs_remove_group(kobj, &siw_hal_abt_attribute_group);
 
 	siw_hal_abt_free(dev);
@@ -30,6 +30,11 @@
 #include <linux/firmware.h>
 #include <linux/time.h>
 #include <linux/fs.h>
+#include <linux/ctype.h>
+#include <linux/mm.h>
+#include <linux/vmalloc.h>
+#include <linux/miscdevice.h>
+#include <asm/uaccess.h>
 
 #include "siw_touch.h"
 #include "siw_touch_hal.h"
@@ -81,13 +86,20 @@ enum {
 	PRD_DATA_NAME_SZ	= 128,
 	/* */
 	PRD_LINE_NUM		= (1<<10),
+	PRD_SPEC_FILE_MAX	= (64<<10),
 //	PRD_PATH_SIZE		= (1<<6),		//64
 //	PRD_BURST_SIZE		= (1<<9),		//512
 	/* */
 	MAX_LOG_FILE_COUNT	= (4),
 	MAX_LOG_FILE_SIZE	= (10 * (1<<20)),	/* 10M byte */
+	PRD_LOG_WR_BUF_SZ	= (64<<10),
 	/* */
 	MAX_TEST_CNT			= 2,
+	/* */
+	PRD_NOISE_FRAMES_DEF	= 16,
+	PRD_NOISE_FRAMES_MAX	= 1024,
+	/* */
+	PRD_STREAM_IDLE_MS		= 2000,
 };
 
 enum {
@@ -131,6 +143,7 @@ enum {
 	PRD_SYS_EN_IDX_APP_END,
 	//
 	PRD_SYS_EN_IDX_APP_INFO,	//16
+	PRD_SYS_EN_IDX_NOISE,
 	//
 	PRD_SYS_ATTR_MAX,
 };
@@ -157,6 +170,7 @@ enum {
 	PRD_SYS_EN_APP_END				= (1<<PRD_SYS_EN_IDX_APP_END),
 	//
 	PRD_SYS_EN_APP_INFO				= (1<<PRD_SYS_EN_IDX_APP_INFO),
+	PRD_SYS_EN_NOISE				= (1<<PRD_SYS_EN_IDX_NOISE),
 };
 
 #define PRD_SYS_ATTR_EN_FLAG 		(0 |	\
@@ -177,6 +191,7 @@ enum {
 									PRD_SYS_EN_APP_DEBUG_BUF |	\
 									PRD_SYS_EN_APP_END |	\
 									PRD_SYS_EN_APP_INFO |	\
+									PRD_SYS_EN_NOISE |	\
 									0)
 
 struct siw_hal_prd_img_cmd {
@@ -262,6 +277,108 @@ struct siw_hal_prd_tune {
 	u32 code_r_g3_oft_offset;
 };
 
+/*
+ * Binary frame device for the app modes (prd_app_xxx)
+ *
+ * /dev/{dev name}-prd
+ * ioctl SIW_PRD_IOC_SET_MODE : select REPORT_xxx, REPORT_OFF releases F/W
+ * ioctl SIW_PRD_IOC_GRAB     : get a frame into the back buffer and flip
+ * read                       : GRAB, then copy the new front frame
+ * mmap                       : struct siw_prd_mmap_ctrl page, then
+ *                              two frame buffers at frame_offset[]
+ *
+ * After GRAB, frame[front] holds the latest frame of len bytes
+ * and the other one is free to be overwritten by the next GRAB.
+ * The ctrl page is writable from user space : mode, front and seq
+ * are kept in struct siw_hal_prd_cdev and only mirrored to it.
+ */
+enum {
+	SIW_PRD_MMAP_MAGIC	= 0x44525053,	/* "SPRD" */
+	SIW_PRD_MMAP_VER	= 1,
+	SIW_PRD_MMAP_BUF_NUM	= 2,
+};
+
+struct siw_prd_mmap_ctrl {
+	u32 magic;
+	u32 version;
+	u32 frame_offset[SIW_PRD_MMAP_BUF_NUM];
+	u32 frame_size;
+	u32 front;
+	u32 seq;
+	u32 mode;
+	u32 len;
+	/* node matrix, same as prd_app_info */
+	u32 row;
+	u32 col;
+	u32 col_add;
+	u32 ch;
+	u32 m1_col;
+	u32 cmd_type;
+} __packed;
+
+#define SIW_PRD_IOC_MAGIC		'P'
+#define SIW_PRD_IOC_SET_MODE	_IOW(SIW_PRD_IOC_MAGIC, 0x01, u32)
+#define SIW_PRD_IOC_GRAB		_IO(SIW_PRD_IOC_MAGIC, 0x02)
+
+struct siw_hal_prd_cdev {
+	struct miscdevice misc;
+	char name[PRD_DATA_NAME_SZ];
+	void *prd;
+	struct mutex lock;
+	int users;
+	void *buf;
+	struct siw_prd_mmap_ctrl *ctrl;
+	u8 *frame[SIW_PRD_MMAP_BUF_NUM];
+	u32 frame_size;
+	u32 buf_size;
+	/* kernel copies, see siw_prd_mmap_ctrl */
+	u32 mode;
+	u32 front;
+	u32 seq;
+};
+
+/*
+ * App-mode streaming session
+ *
+ * While a session is open (sysfs prd_app_* or the frame device),
+ * the F/W is not restarted between frames of the same command.
+ * Each frame still re-arms the capture (release + stop handshake)
+ * so RS_IMAGE always belongs to a new image.
+ * prd_start_firmware drops the armed command, the idle work
+ * does it after PRD_STREAM_IDLE_MS without frames.
+ * cmd is protected by lock.
+ */
+struct siw_hal_prd_stream {
+	struct mutex lock;
+	struct delayed_work idle_work;
+	int active;
+	u32 cmd;		/* armed image command, IT_IMAGE_NONE if running */
+	unsigned long last;
+};
+
+/*
+ * Result log writer
+ *
+ * prd_write_file only appends to the active buffer.
+ * The work swaps the buffers, writes the batch out in one append
+ * and does the rotation requested by prd_log_file_size_check
+ * at the point of the batch where it was requested.
+ */
+struct siw_hal_prd_log {
+	struct mutex lock;
+	struct workqueue_struct *wq;
+	struct work_struct work;
+	char *buf[2];
+	int active;
+	int len;
+	int boot_mode;		/* target of the pending data */
+	int rotate;
+	int rotate_at;		/* pending data before the rotate request */
+	int rotate_boot_mode;
+	int ready;
+	int wr_err;		/* batches lost on write failure */
+};
+
 struct siw_hal_prd_data {
 	struct device *dev;
 	char name[PRD_DATA_NAME_SZ];
@@ -275,6 +392,9 @@ struct siw_hal_prd_data {
 	/* */
 	int prd_app_mode;
 	/* */
+	int noise_frames;
+	int noise_type;
+	/* */
 	u8 *buf_src;
 	int buf_size;
 	int16_t	*m2_buf_even_rawdata;
@@ -286,6 +406,9 @@ struct siw_hal_prd_data {
 	/* */
 	int image_lower;
 	int image_upper;
+	void *spec;		/* struct siw_hal_prd_spec */
+	unsigned long *fail_map;	/* row x col, one compare frame */
+	int fail_map_bits;
 	/* */
 	int16_t	*buf_delta;
 	int16_t	*buf_debug;
@@ -297,8 +420,11 @@ struct siw_hal_prd_data {
 	/* */
 	int mon_flag;
 	/* */
+	struct siw_hal_prd_cdev cdev;
+	struct siw_hal_prd_log log;
+	struct siw_hal_prd_stream stream;
+	/* */
 	char log_buf[PRD_LOG_BUF_SIZE + PRD_BUF_DUMMY];
-	char line[PRD_LINE_NUM + PRD_BUF_DUMMY];
 	char buf_write[PRD_BUF_SIZE + PRD_BUF_DUMMY];
 };
 
@@ -767,6 +893,18 @@ static u32 t_prd_dbg_mask = 0;
  */
 module_param_named(s_prd_dbg_mask, t_prd_dbg_mask, int, S_IRUGO|S_IWUSR|S_IWGRP);
 
+/*
+ * 0 : compare gives the verdict and the summary only,
+ *     the per-node fail lines are not formatted
+ */
+static u32 t_prd_cmp_report = 1;
+
+/* usage
+ * (1) echo <value> > /sys/module/{Siw Touch Module Name}/parameters/s_prd_cmp_report
+ * (2) insmod {Siw Touch Module Name}.ko s_prd_cmp_report=<value>
+ */
+module_param_named(s_prd_cmp_report, t_prd_cmp_report, int, S_IRUGO|S_IWUSR|S_IWGRP);
+
 
 enum {
 	PRD_SHOW_FLAG_DISABLE_PRT_RAW	= (1<<0),
@@ -1313,7 +1451,7 @@ out:
 	return 0;
 }
 
-static int prd_log_file_size_check(struct siw_hal_prd_data *prd)
+static char *prd_out_fname(int boot_mode)
 {
 	char *prd_out_fname[] = {
 		[NORMAL_BOOT]			= __prd_out_file,
@@ -1322,21 +1460,20 @@ static int prd_log_file_size_check(struct siw_hal_prd_data *prd)
 		[MINIOS_MFTS_FLAT]		= __prd_out_file_mo_mfl,
 		[MINIOS_MFTS_CURVED]	= __prd_out_file_mo_mcv,
 	};
-	struct device *dev = prd->dev;
+
+	return prd_out_fname[boot_mode];
+}
+
+static int prd_do_log_file_size_check(struct siw_hal_prd_data *prd,
+				int boot_mode)
+{
 	char *fname = NULL;
 	loff_t file_size = 0;
 	int i = 0;
 	char *buf1 = NULL;
 	char *buf2 = NULL;
-	int boot_mode = 0;
 	int ret = 0;
 
-	boot_mode = siw_touch_boot_mode_check(dev);
-
-	if (__prd_boot_mode_is_err(dev, boot_mode)) {
-		return -EINVAL;
-	}
-
 	buf1 = touch_getname();
 	if (buf1 == NULL) {
 		t_prd_err(prd, "failed to allocate name buffer 1\n");
@@ -1350,7 +1487,7 @@ static int prd_log_file_size_check(struct siw_hal_prd_data *prd)
 		return -ENOMEM;
 	}
 
-	fname = (char *)prd_out_fname[boot_mode];
+	fname = prd_out_fname(boot_mode);
 
 	ret = prd_vfs_file_chk(prd, fname, O_RDONLY, 0666, &file_size);
 	if (ret < 0) {
@@ -1394,6 +1531,23 @@ out:
 	return ret;
 }
 
+static void prd_time_str(char *time_string, int size)
+{
+	struct timespec my_time;
+	struct tm my_date;
+
+	my_time = current_kernel_time();
+	time_to_tm(my_time.tv_sec,
+			sys_tz.tz_minuteswest * 60 * (-1),
+			&my_date);
+	snprintf(time_string, size,
+		"\n[%02d-%02d %02d:%02d:%02d.%03lu]\n",
+		my_date.tm_mon + 1,
+		my_date.tm_mday, my_date.tm_hour,
+		my_date.tm_min, my_date.tm_sec,
+		(unsigned long) my_time.tv_nsec / 1000000);
+}
+
 static int prd_do_write_file(struct siw_hal_prd_data *prd,
 				char *fname,
 				char *data,
@@ -1420,19 +1574,7 @@ static int prd_do_write_file(struct siw_hal_prd_data *prd,
 	}
 
 	if (write_time == TIME_INFO_WRITE) {
-		struct timespec my_time;
-		struct tm my_date;
-
-		my_time = current_kernel_time();
-		time_to_tm(my_time.tv_sec,
-				sys_tz.tz_minuteswest * 60 * (-1),
-				&my_date);
-		snprintf(time_string, 64,
-			"\n[%02d-%02d %02d:%02d:%02d.%03lu]\n",
-			my_date.tm_mon + 1,
-			my_date.tm_mday, my_date.tm_hour,
-			my_date.tm_min, my_date.tm_sec,
-			(unsigned long) my_time.tv_nsec / 1000000);
+		prd_time_str(time_string, sizeof(time_string));
 		ret = prd_kernel_write(filp, (const char *)time_string,
 					strlen(time_string), &offset);
 		if (ret < 0) {
@@ -1464,17 +1606,116 @@ out:
 	return ret;
 }
 
+static void prd_log_write_batch(struct siw_hal_prd_data *prd,
+				int boot_mode, char *data, int len)
+{
+	struct siw_hal_prd_log *log = &prd->log;
+	char tail;
+	int ret;
+
+	if (!len) {
+		return;
+	}
+
+	tail = data[len];
+	data[len] = 0;
+	ret = prd_do_write_file(prd, prd_out_fname(boot_mode),
+			data, TIME_INFO_SKIP);
+	data[len] = tail;
+	if (ret < 0) {
+		log->wr_err++;
+		t_prd_err(prd, "log batch dropped(%d bytes), %d (total %d)\n",
+			len, ret, log->wr_err);
+	}
+}
+
+static void prd_log_work_func(struct work_struct *work)
+{
+	struct siw_hal_prd_log *log =
+			container_of(work, struct siw_hal_prd_log, work);
+	struct siw_hal_prd_data *prd =
+			container_of(log, struct siw_hal_prd_data, log);
+	char *data;
+	int len;
+	int boot_mode;
+	int rotate;
+	int rotate_at;
+	int rotate_boot_mode;
+
+	mutex_lock(&log->lock);
+	data = log->buf[log->active];
+	len = log->len;
+	boot_mode = log->boot_mode;
+	rotate = log->rotate;
+	rotate_at = log->rotate_at;
+	rotate_boot_mode = log->rotate_boot_mode;
+
+	log->active ^= 1;
+	log->len = 0;
+	log->rotate = 0;
+	mutex_unlock(&log->lock);
+
+	if (rotate) {
+		/* what was queued before the request stays in the old file */
+		prd_log_write_batch(prd, boot_mode, data, rotate_at);
+		prd_do_log_file_size_check(prd, rotate_boot_mode);
+		data += rotate_at;
+		len -= rotate_at;
+	}
+
+	prd_log_write_batch(prd, boot_mode, data, len);
+}
+
+/*
+ * Waits until everything queued so far is on the file
+ */
+static void prd_log_flush(struct siw_hal_prd_data *prd)
+{
+	struct siw_hal_prd_log *log = &prd->log;
+
+	if (!log->ready) {
+		return;
+	}
+
+	queue_work(log->wq, &log->work);
+	flush_work(&log->work);
+}
+
+static int prd_log_append(struct siw_hal_prd_data *prd,
+				int boot_mode, char *data)
+{
+	struct siw_hal_prd_log *log = &prd->log;
+	int len = strlen(data);
+
+	if (len > PRD_LOG_WR_BUF_SZ) {
+		prd_log_flush(prd);
+		return prd_do_write_file(prd, prd_out_fname(boot_mode),
+					data, TIME_INFO_SKIP);
+	}
+
+	mutex_lock(&log->lock);
+	/* one batch goes to one file */
+	while (log->len &&
+		((log->boot_mode != boot_mode) ||
+		((log->len + len) > PRD_LOG_WR_BUF_SZ))) {
+		mutex_unlock(&log->lock);
+		prd_log_flush(prd);
+		mutex_lock(&log->lock);
+	}
+	memcpy(&log->buf[log->active][log->len], data, len);
+	log->len += len;
+	log->boot_mode = boot_mode;
+	mutex_unlock(&log->lock);
+
+	queue_work(log->wq, &log->work);
+
+	return len;
+}
+
 static int prd_write_file(struct siw_hal_prd_data *prd, char *data, int write_time)
 {
-	char *prd_out_fname[] = {
-		[NORMAL_BOOT]			= __prd_out_file,
-		[MINIOS_AAT]			= __prd_out_file_mo_aat,
-		[MINIOS_MFTS_FOLDER]	= __prd_out_file_mo_mfo,
-		[MINIOS_MFTS_FLAT]		= __prd_out_file_mo_mfl,
-		[MINIOS_MFTS_CURVED]	= __prd_out_file_mo_mcv,
-	};
 	struct device *dev = prd->dev;
-	char *fname = NULL;
+	char time_string[PRD_TIME_STR_SZ] = {0, };
 	int boot_mode = 0;
 	int ret = 0;
 
@@ -1483,13 +1724,108 @@ static int prd_write_file(struct siw_hal_prd_data *prd, char *data, int write_ti
 		return -EINVAL;
 	}
 
-	fname = (char *)prd_out_fname[boot_mode];
+	if (!prd->log.ready) {
+		return prd_do_write_file(prd, prd_out_fname(boot_mode),
+					data, write_time);
+	}
+
+	if (write_time == TIME_INFO_WRITE) {
+		prd_time_str(time_string, sizeof(time_string));
+		ret = prd_log_append(prd, boot_mode, time_string);
+		if (ret < 0) {
+			return ret;
+		}
+	}
 
-	ret = prd_do_write_file(prd, fname, data, write_time);
+	ret = prd_log_append(prd, boot_mode, data);
 
 	return ret;
 }
 
+static int prd_log_file_size_check(struct siw_hal_prd_data *prd)
+{
+	struct siw_hal_prd_log *log = &prd->log;
+	struct device *dev = prd->dev;
+	int boot_mode = 0;
+
+	boot_mode = siw_touch_boot_mode_check(dev);
+	if (__prd_boot_mode_is_err(dev, boot_mode)) {
+		return -EINVAL;
+	}
+
+	if (!log->ready) {
+		return prd_do_log_file_size_check(prd, boot_mode);
+	}
+
+	/* done by the work between the pending data and what follows */
+	mutex_lock(&log->lock);
+	if (!log->rotate) {
+		log->rotate = 1;
+		log->rotate_at = log->len;
+		log->rotate_boot_mode = boot_mode;
+	}
+	mutex_unlock(&log->lock);
+
+	queue_work(log->wq, &log->work);
+
+	return 0;
+}
+
+static void prd_log_init(struct siw_hal_prd_data *prd)
+{
+	struct siw_hal_prd_log *log = &prd->log;
+
+	mutex_init(&log->lock);
+	INIT_WORK(&log->work, prd_log_work_func);
+
+	log->buf[0] = vmalloc(PRD_LOG_WR_BUF_SZ + 1);
+	log->buf[1] = vmalloc(PRD_LOG_WR_BUF_SZ + 1);
+	if (!log->buf[0] || !log->buf[1]) {
+		t_prd_warn(prd, "log buffer not allocated, sync write\n");
+		goto out_free;
+	}
+
+	log->wq = create_singlethread_workqueue("siw_prd_log");
+	if (log->wq == NULL) {
+		t_prd_warn(prd, "log workqueue not created, sync write\n");
+		goto out_free;
+	}
+
+	log->ready = 1;
+
+	return;
+
+out_free:
+	vfree(log->buf[1]);
+	vfree(log->buf[0]);
+	log->buf[1] = NULL;
+	log->buf[0] = NULL;
+}
+
+static void prd_log_free(struct siw_hal_prd_data *prd)
+{
+	struct siw_hal_prd_log *log = &prd->log;
+
+	if (!log->ready) {
+		return;
+	}
+
+	prd_log_flush(prd);
+	log->ready = 0;
+
+	if (log->wr_err) {
+		t_prd_warn(prd, "log: %d batches lost on write\n", log->wr_err);
+	}
+
+	destroy_workqueue(log->wq);
+	log->wq = NULL;
+
+	vfree(log->buf[1]);
+	vfree(log->buf[0]);
+	log->buf[1] = NULL;
+	log->buf[0] = NULL;
+}
+
 static int prd_write_test_mode(struct siw_hal_prd_data *prd, u8 type)
 {
 	struct device *dev = prd->dev;
@@ -1563,159 +1899,392 @@ out:
 	return 0;
 }
 
-static int prd_spec_file_read_ext(struct siw_hal_prd_data *prd)
+/*
+ * Spec limits
+ *
+ * The spec file is parsed once and kept until its path or,
+ * for the external file, its size or mtime changes.
+ *
+ * {key} ... value,  : global limit (digits right before the first ',')
+ * {key}_Node ...    : optional per-node table, row x col values
+ *                     separated by ',' or white spaces
+ */
+struct siw_hal_prd_limit {
+	int valid;
+	int lower;
+	int upper;
+	int16_t *node_lower;	/* row x col, NULL if not given */
+	int16_t *node_upper;
+};
+
+struct siw_hal_prd_spec {
+	int valid;
+	char fname[PRD_TMP_FILE_NAME_SZ];
+	int ext;
+	loff_t size;
+	long mtime_sec;
+	long mtime_nsec;
+	struct siw_hal_prd_limit limit[UX_INVALID];
+};
+
+static void prd_spec_clear(struct siw_hal_prd_spec *spec)
 {
-	char *prd_in_fname[] = {
-		[0]	= __prd_in_file,
-		[1]	= __prd_in_file_m,
-	};
-	struct device *dev = prd->dev;
-	struct file *filp = NULL;
-	loff_t offset = 0;
-	char *fname;
-	int path_idx = 0;
-	int ret = 0;
+	struct siw_hal_prd_limit *limit;
+	int i;
+
+	for (i = 0; i < UX_INVALID; i++) {
+		limit = &spec->limit[i];
+		kfree(limit->node_lower);
+		kfree(limit->node_upper);
+	}
+
+	memset(spec, 0, sizeof(*spec));
+}
+
+static void prd_spec_free(struct siw_hal_prd_data *prd)
+{
+	if (prd->spec == NULL) {
+		return;
+	}
+
+	prd_spec_clear(prd->spec);
+	kfree(prd->spec);
+	prd->spec = NULL;
+}
+
+/*
+ * Returns 1 if the external spec file is the one already parsed
+ */
+static int prd_spec_ext_same(struct siw_hal_prd_data *prd,
+			struct siw_hal_prd_spec *spec, struct file *filp, char *fname)
+{
+	struct inode *inode = filp->f_path.dentry->d_inode;
+
+	return spec->valid && spec->ext &&
+		!strncmp(spec->fname, fname, sizeof(spec->fname)) &&
+		(spec->size == i_size_read(inode)) &&
+		(spec->mtime_sec == inode->i_mtime.tv_sec) &&
+		(spec->mtime_nsec == inode->i_mtime.tv_nsec);
+}
 
-	path_idx = !!(siw_touch_boot_mode_check(dev) >= MINIOS_MFTS_FOLDER);
-	fname = (char *)prd_in_fname[path_idx];
+static char *prd_spec_file_read_ext(struct siw_hal_prd_data *prd,
+			struct siw_hal_prd_spec *spec, char *fname, int *len)
+{
+	struct file *filp = NULL;
+	struct inode *inode;
+	loff_t size;
+	char *text = NULL;
+	int ret;
 
 	filp = prd_vfs_file_open(prd, fname, O_RDONLY, 0);
 	if (filp == NULL) {
-		ret = -ENOENT;
+		return ERR_PTR(-ENOENT);
+	}
+
+	if (prd_spec_ext_same(prd, spec, filp, fname)) {
+		text = NULL;
 		goto out;
 	}
 
-	kernel_read(filp, offset, (char *)prd->line, sizeof(prd->line));
+	inode = filp->f_path.dentry->d_inode;
+	size = min_t(loff_t, i_size_read(inode), PRD_SPEC_FILE_MAX);
 
-	filp_close(filp, 0);
+	text = vmalloc(size + 1);
+	if (text == NULL) {
+		text = ERR_PTR(-ENOMEM);
+		goto out;
+	}
+
+	ret = kernel_read(filp, 0, text, size);
+	if (ret < 0) {
+		vfree(text);
+		text = ERR_PTR(ret);
+		goto out;
+	}
+	text[ret] = 0;
+	*len = ret;
+
+	prd_spec_clear(spec);
+	strlcpy(spec->fname, fname, sizeof(spec->fname));
+	spec->ext = 1;
+	spec->size = i_size_read(inode);
+	spec->mtime_sec = inode->i_mtime.tv_sec;
+	spec->mtime_nsec = inode->i_mtime.tv_nsec;
 
 	t_prd_info(prd, "file detected : %s\n", fname);
 
 out:
-	return ret;
+	filp_close(filp, 0);
+
+	return text;
 }
 
-static int prd_spec_file_read(struct siw_hal_prd_data *prd)
+static char *prd_spec_file_read(struct siw_hal_prd_data *prd,
+			struct siw_hal_prd_spec *spec, char *fname, int *len)
 {
 	struct device *dev = prd->dev;
-	struct siw_touch_chip *chip = to_touch_chip(dev);
-	struct siw_ts *ts = chip->ts;
 	const struct firmware *fwlimit = NULL;
-	const char *path[2] = {
-		ts->panel_spec,
-		ts->panel_spec_mfts
-	};
-	char *fname;
-	int path_idx = 0;
+	char *text = NULL;
+	int size;
 	int ret = 0;
 
-	path_idx = !!(siw_touch_boot_mode_check(dev) >= MINIOS_MFTS_FOLDER);
-	fname = (char *)path[path_idx];
-
-	if (ts->panel_spec == NULL || ts->panel_spec_mfts == NULL) {
+	if (fname == NULL) {
 		t_prd_err(prd, "panel spec file name is null\n");
-		ret = -EINVAL;
-		goto out;
+		return ERR_PTR(-EINVAL);
+	}
+
+	/* request_firmware image doesn't change under the same name */
+	if (spec->valid && !spec->ext &&
+		!strncmp(spec->fname, fname, sizeof(spec->fname))) {
+		return NULL;
 	}
 
 	ret = request_firmware(&fwlimit, fname, dev);
 	if (ret < 0) {
 		t_prd_err(prd, "request file is failed in normal mode\n");
-		goto out;
+		return ERR_PTR(ret);
 	}
 
 	if (fwlimit->data == NULL) {
-		ret = -EFAULT;
 		t_prd_err(prd, "fwlimit->data is NULL\n");
+		text = ERR_PTR(-EFAULT);
+		goto out;
+	}
+
+	size = min_t(int, fwlimit->size, PRD_SPEC_FILE_MAX);
+
+	text = vmalloc(size + 1);
+	if (text == NULL) {
+		text = ERR_PTR(-ENOMEM);
 		goto out;
 	}
+	memcpy(text, fwlimit->data, size);
+	text[size] = 0;
+	*len = size;
 
-	strlcpy(prd->line, fwlimit->data, sizeof(prd->line));
+	prd_spec_clear(spec);
+	strlcpy(spec->fname, fname, sizeof(spec->fname));
 
 out:
-	if (fwlimit)
-		release_firmware(fwlimit);
+	release_firmware(fwlimit);
 
-	return ret;
+	return text;
 }
 
-static int prd_get_limit(struct siw_hal_prd_data *prd,
-		int row, int col,
-		char *breakpoint, int *limit)
+/*
+ * Returns the position right after the key,
+ * skipping longer keys sharing the prefix ({key}_Node for {key})
+ */
+static char *prd_spec_find(char *text, int len, const char *key)
 {
-	struct device *dev = prd->dev;
-	int p = 0;
-	int q = 0;
-	int q_limit;
-	int cipher = 1;
-	char *found;
-	int boot_mode = 0;
-	int value = ~0;
-	int ret = 0;
+	char *end = text + len;
+	char *pos = text;
+	int klen = strlen(key);
+
+	while ((pos = strnstr(pos, key, end - pos)) != NULL) {
+		pos += klen;
+		if ((pos >= end) || ((*pos != '_') && !isalnum(*pos))) {
+			return pos;
+		}
+	}
 
-	if (limit)
-		*limit = ~0;
+	return NULL;
+}
 
-	if (breakpoint == NULL) {
-		ret = -EINVAL;
-		goto out;
-	}
+static int prd_spec_parse_value(struct siw_hal_prd_data *prd,
+			char *text, int len, const char *key, int *value)
+{
+	char *end = text + len;
+	char *pos;
+	char *q;
+	int cipher = 1;
+	int val = 0;
 
-	boot_mode = siw_touch_boot_mode_check(dev);
-	if ((boot_mode > MINIOS_MFTS_CURVED) ||
-		(boot_mode < NORMAL_BOOT)) {
-		ret = -EINVAL;
-		goto out;
+	pos = prd_spec_find(text, len, key);
+	if (pos == NULL) {
+		return -ENOENT;
 	}
 
-	ret = prd_spec_file_read_ext(prd);
-	if (ret < 0) {
-		ret = prd_spec_file_read(prd);
-		if (ret < 0)
-			goto out;
+	q = memchr(pos, ',', end - pos);
+	if ((q == NULL) || (q == pos) || !isdigit(q[-1])) {
+		t_prd_err(prd, "%s found, but getting num failed\n", key);
+		return -EFAULT;
 	}
 
-	found = strnstr(prd->line, breakpoint, sizeof(prd->line));
-	if (found == NULL) {
-		t_prd_err(prd,
-			"failed to find %s, spec file is wrong\n",
-			breakpoint);
-		ret = -EFAULT;
-		goto out;
+	while ((--q >= pos) && isdigit(*q)) {
+		val += (*q - '0') * cipher;
+		cipher *= 10;
 	}
-	q = found - prd->line;
 
-	q_limit = ARRAY_SIZE(prd->line);
-	while (q < q_limit) {
-		if (prd->line[q] == ',') {
-			value = 0;
+	*value = val;
 
-			cipher = 1;
-			for (p = 1; (prd->line[q - p] >= '0') &&
-					(prd->line[q - p] <= '9'); p++) {
-				value += ((prd->line[q - p] - '0') * cipher);
-				cipher *= 10;
-			}
+	return 0;
+}
 
-			if (limit)
-				*limit = value;
+static int16_t *prd_spec_parse_node(struct siw_hal_prd_data *prd,
+			char *text, int len, const char *key, int cnt)
+{
+	char node_key[64];
+	char *end = text + len;
+	char *pos;
+	char *next;
+	int16_t *tbl;
+	int i = 0;
 
-			t_prd_info(prd, "scanning spec file done, %s = %d\n",
-					breakpoint, value);
+	snprintf(node_key, sizeof(node_key), "%s_Node", key);
 
-			break;
+	pos = prd_spec_find(text, len, node_key);
+	if (pos == NULL) {
+		return NULL;
+	}
+
+	tbl = kcalloc(cnt, sizeof(*tbl), GFP_KERNEL);
+	if (tbl == NULL) {
+		return NULL;
+	}
+
+	while ((i < cnt) && (pos < end)) {
+		if (!isdigit(*pos) && (*pos != '-')) {
+			pos++;
+			continue;
+		}
+		tbl[i] = (int16_t)simple_strtol(pos, &next, 10);
+		if (next == pos) {
+			pos++;
+			continue;
 		}
-		q++;
+		pos = next;
+		i++;
 	}
 
-	if (value == ~0) {
-		t_prd_err(prd, "%s found, but getting num failed\n", breakpoint);
-		ret = -EFAULT;
-		goto out;
+	if (i < cnt) {
+		t_prd_err(prd, "%s: %d of %d nodes, ignored\n", node_key, i, cnt);
+		kfree(tbl);
+		return NULL;
 	}
 
-out:
-	return ret;
+	return tbl;
+}
+
+static void prd_spec_parse(struct siw_hal_prd_data *prd,
+			struct siw_hal_prd_spec *spec, char *text, int len)
+{
+	struct siw_hal_prd_param *param = &prd->param;
+	struct siw_hal_prd_limit *limit;
+	int cnt;
+	int type;
+
+	for (type = 0; type < UX_INVALID; type++) {
+		if (prd_cmp_tool_str[type][0] == NULL) {
+			continue;
+		}
+
+		limit = &spec->limit[type];
+
+		if ((prd_spec_parse_value(prd, text, len,
+				prd_cmp_tool_str[type][0], &limit->lower) < 0) ||
+			(prd_spec_parse_value(prd, text, len,
+				prd_cmp_tool_str[type][1], &limit->upper) < 0)) {
+			continue;
+		}
+		limit->valid = 1;
+
+		cnt = param->row;
+		cnt *= (type == U0_M1_RAWDATA_TEST) ? param->m1_col : param->col;
+
+		limit->node_lower = prd_spec_parse_node(prd, text, len,
+						prd_cmp_tool_str[type][0], cnt);
+		limit->node_upper = prd_spec_parse_node(prd, text, len,
+						prd_cmp_tool_str[type][1], cnt);
+		if (!limit->node_lower || !limit->node_upper) {
+			kfree(limit->node_lower);
+			kfree(limit->node_upper);
+			limit->node_lower = NULL;
+			limit->node_upper = NULL;
+		}
+
+		t_prd_info(prd, "spec %s/%s = %d/%d%s\n",
+			prd_cmp_tool_str[type][0], prd_cmp_tool_str[type][1],
+			limit->lower, limit->upper,
+			(limit->node_lower) ? ", per-node" : "");
+	}
+
+	spec->valid = 1;
+}
+
+static int prd_spec_load(struct siw_hal_prd_data *prd)
+{
+	struct device *dev = prd->dev;
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	struct siw_hal_prd_spec *spec = prd->spec;
+	char *prd_in_fname[] = {
+		[0]	= __prd_in_file,
+		[1]	= __prd_in_file_m,
+	};
+	char *path[2] = {
+		ts->panel_spec,
+		ts->panel_spec_mfts
+	};
+	char *text;
+	int boot_mode;
+	int path_idx;
+	int len = 0;
+
+	boot_mode = siw_touch_boot_mode_check(dev);
+	if ((boot_mode > MINIOS_MFTS_CURVED) ||
+		(boot_mode < NORMAL_BOOT)) {
+		return -EINVAL;
+	}
+	path_idx = !!(boot_mode >= MINIOS_MFTS_FOLDER);
+
+	if (spec == NULL) {
+		spec = kzalloc(sizeof(*spec), GFP_KERNEL);
+		if (spec == NULL) {
+			return -ENOMEM;
+		}
+		prd->spec = spec;
+	}
+
+	text = prd_spec_file_read_ext(prd, spec, prd_in_fname[path_idx], &len);
+	if (IS_ERR(text)) {
+		text = prd_spec_file_read(prd, spec, path[path_idx], &len);
+		if (IS_ERR(text)) {
+			return PTR_ERR(text);
+		}
+	}
+
+	/* NULL : unchanged */
+	if (text != NULL) {
+		prd_spec_parse(prd, spec, text, len);
+		vfree(text);
+	}
+
+	return 0;
+}
+
+static struct siw_hal_prd_limit *prd_get_limit(struct siw_hal_prd_data *prd,
+					int type)
+{
+	struct siw_hal_prd_spec *spec;
+	struct siw_hal_prd_limit *limit;
+	int ret;
+
+	ret = prd_spec_load(prd);
+	if (ret < 0) {
+		return ERR_PTR(ret);
+	}
+
+	spec = prd->spec;
+	limit = &spec->limit[type];
+	if (!limit->valid) {
+		t_prd_err(prd,
+			"failed to find %s/%s, spec file is wrong\n",
+			prd_cmp_tool_str[type][0], prd_cmp_tool_str[type][1]);
+		return ERR_PTR(-EFAULT);
+	}
+
+	return limit;
 }
 
 static int prd_os_result_get(struct siw_hal_prd_data *prd, u32 *buf, int type)
@@ -1937,6 +2506,115 @@ static int prd_open_short_test(struct siw_hal_prd_data *prd)
 	return ret;
 }
 
+/*
+ * Rawdata statistics
+ *
+ * One pass over the node matrix without any formatting.
+ * min is taken over non-zero nodes as the raw view reports it.
+ * With limits given, nodes out of range are counted and marked
+ * in prd->fail_map (index : i * col + j).
+ * In the second screen area only non-zero nodes can fail.
+ */
+struct siw_hal_prd_stat {
+	int cnt;
+	int min;
+	int max;
+	int mean;
+	int stddev;
+	int fail;
+};
+
+static void prd_stat_calc(struct siw_hal_prd_data *prd,
+			struct siw_hal_prd_stat *stat,
+			int16_t *raw_buf, int row, int col, int col_add,
+			struct siw_hal_prd_limit *limit,
+			struct siw_touch_second_screen *second_screen)
+{
+	unsigned long *fail_map = NULL;
+	int16_t *raw;
+	int16_t *node_lower = NULL;
+	int16_t *node_upper = NULL;
+	int lower = 0;
+	int upper = 0;
+	int min = 9999;
+	int max = 0;
+	int fail = 0;
+	int scr_j;
+	int i, j;
+	int v, l, u, out;
+	s64 sum = 0;
+	u64 sum_sq = 0;
+	s64 mean;
+	s64 var;
+
+	memset(stat, 0, sizeof(*stat));
+
+	if (limit != NULL) {
+		lower = limit->lower;
+		upper = limit->upper;
+		fail_map = prd->fail_map;
+		if ((fail_map == NULL) || ((row * col) > prd->fail_map_bits)) {
+			fail_map = NULL;
+		} else {
+			bitmap_zero(fail_map, row * col);
+		}
+	}
+
+	raw = raw_buf;
+	for (i = 0; i < row; i++) {
+		if ((limit != NULL) && (limit->node_lower != NULL)) {
+			node_lower = &limit->node_lower[i * col];
+			node_upper = &limit->node_upper[i * col];
+		}
+
+		scr_j = 0;
+		if ((second_screen != NULL) && (i <= second_screen->bound_i)) {
+			scr_j = second_screen->bound_j + 1;
+		}
+
+		for (j = 0; j < col; j++) {
+			v = raw[j];
+
+			sum += v;
+			sum_sq += (u64)(v * v);
+			max = (v > max) ? v : max;
+			min = (v && (v < min)) ? v : min;
+
+			if (limit == NULL) {
+				continue;
+			}
+
+			l = (node_lower) ? node_lower[j] : lower;
+			u = (node_upper) ? node_upper[j] : upper;
+
+			out = (v < l) | (v > u);
+			out &= (j >= scr_j) | !!v;
+
+			fail += out;
+			if (out && fail_map) {
+				__set_bit((i * col) + j, fail_map);
+			}
+		}
+
+		raw += (col + col_add);
+	}
+
+	stat->cnt = row * col;
+	stat->min = min;
+	stat->max = max;
+	stat->fail = fail;
+
+	if (!stat->cnt) {
+		return;
+	}
+
+	mean = div_s64(sum, stat->cnt);
+	var = (s64)div_u64(sum_sq, stat->cnt) - (mean * mean);
+
+	stat->mean = (int)mean;
+	stat->stddev = (var > 0) ? (int)int_sqrt((unsigned long)var) : 0;
+}
+
 static int prd_print_pre(struct siw_hal_prd_data *prd, char *buf,
 				int size, int row_size, int col_size,
 				const char *name)
@@ -2003,6 +2681,7 @@ static int prd_print_xxx(struct siw_hal_prd_data *prd, char *buf,
 	int log_size = 0;
 	int min = 9999;
 	int max = 0;
+	struct siw_hal_prd_stat stat;
 
 	if (type >= PRD_PRT_TYPE_MAX) {
 		t_prd_err(prd, "invalid print type, %d\n", type);
@@ -2014,6 +2693,22 @@ static int prd_print_xxx(struct siw_hal_prd_data *prd, char *buf,
 		return -EFAULT;
 	}
 
+	if (type == PRD_PRT_TYPE_S16) {
+		prd_stat_calc(prd, &stat, rawdata_s16,
+				row_size, col_size, col_add, NULL, NULL);
+		min = stat.min;
+		max = stat.max;
+	} else {
+		for (i = 0; i < row_size; i++) {
+			rawdata_u8 = &((u8 *)rawdata_buf)[i * (col_size + col_add)];
+			for (j = 0; j < col_size; j++) {
+				curr_raw = rawdata_u8[j];
+				max = (curr_raw > max) ? curr_raw : max;
+				min = (curr_raw && (curr_raw < min)) ? curr_raw : min;
+			}
+		}
+	}
+
 	size = prd_print_pre(prd, buf, size, row_size, col_size, name);
 
 	col_i = 0;
@@ -2043,13 +2738,6 @@ static int prd_print_xxx(struct siw_hal_prd_data *prd, char *buf,
 			log_size += siw_prd_buf_snprintf(log_buf,
 							log_size,
 							"%5d ", curr_raw);
-
-			if (curr_raw && (curr_raw < min)) {
-				min = curr_raw;
-			}
-			if (curr_raw > max) {
-				max = curr_raw;
-			}
 		}
 		t_prd_info(prd, "%s\n", log_buf);
 
@@ -2134,10 +2822,47 @@ static int prd_print_rawdata(struct siw_hal_prd_data *prd,
 	return size;
 }
 
+/*
+*	return "result Pass:0 , Fail:1"
+*/
+static int prd_compare_report(struct siw_hal_prd_data *prd, int size,
+				int16_t *raw_buf, int row, int col, int col_add,
+				struct siw_touch_second_screen *second_screen)
+{
+	int16_t *raw;
+	int raw_err;
+	int bit;
+	int i, j;
+
+	for_each_set_bit(bit, prd->fail_map, row * col) {
+		i = bit / col;
+		j = bit % col;
+		raw = &raw_buf[i * (col + col_add)];
+
+		raw_err = 1;
+		if ((second_screen != NULL) &&
+			(i <= second_screen->bound_i) &&
+			(j <= second_screen->bound_j)) {
+			raw_err = 2;
+		}
+
+		t_prd_info(prd,
+			"F [%d][%d] = %d(%d)\n",
+			i, j, raw[j], raw_err);
+		size += siw_prd_buf_snprintf(prd->buf_write,
+					size,
+					"F [%d][%d] = %d(%d)\n",
+					i, j, raw[j], raw_err);
+	}
+
+	return size;
+}
+
 /*
 *	return "result Pass:0 , Fail:1"
 */
 static int prd_compare_tool(struct siw_hal_prd_data *prd,
+				struct siw_hal_prd_limit *limit,
 				int test_cnt, int16_t **buf,
 				int row, int col, int type, int opt)
 {
@@ -2145,15 +2870,12 @@ static int prd_compare_tool(struct siw_hal_prd_data *prd,
 //	struct device *dev = prd->dev;
 //	struct siw_ts *ts = to_touch_core(dev);
 	struct siw_touch_second_screen *second_screen = NULL;
+	struct siw_hal_prd_stat stat;
 	int16_t *raw_buf;
-	int16_t *raw_curr;
-	int i, j ,k;
-	int col_i;
+	int k;
 	int col_add = (opt) ? param->col_add : 0;
 	int size = 0;
-	int curr_raw;
 	int curr_lower, curr_upper;
-	int raw_err;
 	int	result = 0;
 
 	if (!test_cnt) {
@@ -2168,12 +2890,14 @@ static int prd_compare_tool(struct siw_hal_prd_data *prd,
 	curr_lower = prd->image_lower;
 	curr_upper = prd->image_upper;
 
-	t_prd_info(prd, "lower %d, upper %d\n",
-		curr_lower, curr_upper);
+	t_prd_info(prd, "lower %d, upper %d%s\n",
+		curr_lower, curr_upper,
+		(limit->node_lower) ? ", per-node" : "");
 	size += siw_prd_buf_snprintf(prd->buf_write,
 				size,
-				"lower %d, upper %d\n",
-				curr_lower, curr_upper);
+				"lower %d, upper %d%s\n",
+				curr_lower, curr_upper,
+				(limit->node_lower) ? ", per-node" : "");
 
 	if (type != U0_M1_RAWDATA_TEST) {
 		second_screen = &param->second_scr;
@@ -2196,49 +2920,28 @@ static int prd_compare_tool(struct siw_hal_prd_data *prd,
 					"compare failed: NULL buf\n");
 			goto out;
 		}
-		col_i = 0;
-
-		for (i = 0; i < row; i++) {
-			raw_curr = &raw_buf[col_i];
-
-			for (j = 0; j < col; j++) {
-				curr_raw = *raw_curr++;
-
-				if ((curr_raw >= curr_lower) &&
-					(curr_raw <= curr_upper)) {
-				#if 0
-					t_prd_info(prd,
-						"G [%d][%d] = %d\n",
-						i, j, curr_raw);
-				#endif
-					continue;
-				}
 
-				raw_err = 1;
-				if ((second_screen != NULL) &&
-					(i <= second_screen->bound_i) &&
-					(j <= second_screen->bound_j)) {
-					raw_err = !!(curr_raw)<<1;	/* 2 or 0 */
-				}
+		prd_stat_calc(prd, &stat, raw_buf, row, col, col_add,
+				limit, second_screen);
 
-				if (raw_err) {
-					result = 1;
-					t_prd_info(prd,
-						"F [%d][%d] = %d(%d)\n",
-						i, j, curr_raw, raw_err);
-					size += siw_prd_buf_snprintf(prd->buf_write,
-								size,
-								"F [%d][%d] = %d(%d)\n",
-								i, j, curr_raw, raw_err);
-				} else {
-				#if 0
-					t_prd_info(prd,
-						"G [%d][%d] = %d\n",
-						i, j, curr_raw);
-				#endif
-				}
+		t_prd_info(prd,
+			"min %d, max %d, mean %d, stddev %d, fail %d/%d\n",
+			stat.min, stat.max, stat.mean, stat.stddev,
+			stat.fail, stat.cnt);
+
+		if (stat.fail) {
+			result = 1;
+			if (t_prd_cmp_report &&
+				(prd->fail_map != NULL) &&
+				((row * col) <= prd->fail_map_bits)) {
+				size = prd_compare_report(prd, size,
+						raw_buf, row, col, col_add,
+						second_screen);
+			} else {
+				size += siw_prd_buf_snprintf(prd->buf_write,
+							size,
+							"F %d nodes\n", stat.fail);
 			}
-			col_i += (col + col_add);
 		}
 
 		if (!result) {
@@ -2265,9 +2968,7 @@ static int prd_compare_rawdata(struct siw_hal_prd_data *prd, int type)
 {
 	struct siw_hal_prd_param *param = &prd->param;
 //	struct device *dev = prd->dev;
-	/* spec reading */
-	char lower_str[64] = {0, };
-	char upper_str[64] = {0, };
+	struct siw_hal_prd_limit *limit;
 	int16_t *rawdata_buf[MAX_TEST_CNT] = {
 		[0] = prd->m2_buf_even_rawdata,
 		[1] = prd->m2_buf_odd_rawdata,
@@ -2283,9 +2984,6 @@ static int prd_compare_rawdata(struct siw_hal_prd_data *prd, int type)
 		return -EINVAL;
 	}
 
-	snprintf(lower_str, sizeof(lower_str), prd_cmp_tool_str[type][0]);
-	snprintf(upper_str, sizeof(upper_str), prd_cmp_tool_str[type][1]);
-
 	switch (type) {
 	case U0_M2_RAWDATA_TEST:
 		/* fall through */
@@ -2305,19 +3003,15 @@ static int prd_compare_rawdata(struct siw_hal_prd_data *prd, int type)
 		break;
 	}
 
-	ret = prd_get_limit(prd, row_size, col_size,
-				lower_str, &prd->image_lower);
-	if (ret < 0) {
-		goto out;
-	}
-
-	ret = prd_get_limit(prd, row_size, col_size,
-				upper_str, &prd->image_upper);
-	if (ret < 0) {
+	limit = prd_get_limit(prd, type);
+	if (IS_ERR(limit)) {
+		ret = PTR_ERR(limit);
 		goto out;
 	}
+	prd->image_lower = limit->lower;
+	prd->image_upper = limit->upper;
 
-	ret = prd_compare_tool(prd, test_cnt,
+	ret = prd_compare_tool(prd, limit, test_cnt,
 				rawdata_buf, row_size, col_size, type, opt);
 
 out:
@@ -2375,7 +3069,10 @@ out:
 	return ret;
 }
 
-static int prd_start_firmware(struct siw_hal_prd_data *prd)
+/*
+ * Called with stream->lock held
+ */
+static int __prd_start_firmware(struct siw_hal_prd_data *prd)
 {
 	struct device *dev = prd->dev;
 	struct siw_touch_chip *chip = to_touch_chip(dev);
@@ -2385,6 +3082,8 @@ static int prd_start_firmware(struct siw_hal_prd_data *prd)
 	u32 read_val = 0;
 	int ret = 0;
 
+	prd->stream.cmd = IT_IMAGE_NONE;
+
 	/* Release F/W to operate */
 	ret = siw_hal_write_value(dev, reg->prd_ic_ait_start_reg, cmd);
 	if (ret < 0) {
@@ -2413,6 +3112,83 @@ out:
 	return ret;
 }
 
+static int prd_start_firmware(struct siw_hal_prd_data *prd)
+{
+	int ret;
+
+	mutex_lock(&prd->stream.lock);
+	ret = __prd_start_firmware(prd);
+	mutex_unlock(&prd->stream.lock);
+
+	return ret;
+}
+
+static void prd_stream_idle_work_func(struct work_struct *work)
+{
+	struct siw_hal_prd_stream *stream =
+			container_of(to_delayed_work(work),
+				struct siw_hal_prd_stream, idle_work);
+	struct siw_hal_prd_data *prd =
+			container_of(stream, struct siw_hal_prd_data, stream);
+	unsigned long expire;
+
+	mutex_lock(&stream->lock);
+
+	if (!stream->active || (stream->cmd == IT_IMAGE_NONE)) {
+		goto out;
+	}
+
+	expire = stream->last + msecs_to_jiffies(PRD_STREAM_IDLE_MS);
+	if (time_before(jiffies, expire)) {
+		schedule_delayed_work(&stream->idle_work, expire - jiffies);
+		goto out;
+	}
+
+	t_prd_info(prd, "stream idle, restart F/W\n");
+	__prd_start_firmware(prd);
+
+out:
+	mutex_unlock(&stream->lock);
+}
+
+static void prd_stream_init(struct siw_hal_prd_data *prd)
+{
+	struct siw_hal_prd_stream *stream = &prd->stream;
+
+	mutex_init(&stream->lock);
+	INIT_DELAYED_WORK(&stream->idle_work, prd_stream_idle_work_func);
+}
+
+static void prd_stream_open(struct siw_hal_prd_data *prd)
+{
+	struct siw_hal_prd_stream *stream = &prd->stream;
+
+	mutex_lock(&stream->lock);
+	if (!stream->active) {
+		stream->active = 1;
+		stream->cmd = IT_IMAGE_NONE;
+		t_prd_dbg_base(prd, "stream opened\n");
+	}
+	mutex_unlock(&stream->lock);
+}
+
+/*
+ * The caller restarts F/W as before
+ */
+static void prd_stream_close(struct siw_hal_prd_data *prd)
+{
+	struct siw_hal_prd_stream *stream = &prd->stream;
+
+	cancel_delayed_work_sync(&stream->idle_work);
+
+	mutex_lock(&stream->lock);
+	if (stream->active) {
+		stream->active = 0;
+		t_prd_dbg_base(prd, "stream closed\n");
+	}
+	mutex_unlock(&stream->lock);
+}
+
 /*
  * Conrtol LCD Backlightness
  */
@@ -3198,6 +3974,7 @@ static int prd_show_prd_get_data_raw_core(struct device *dev,
 	struct siw_ts *ts = chip->ts;
 	struct siw_hal_reg *reg = chip->reg;
 	struct siw_hal_prd_data *prd = (struct siw_hal_prd_data *)ts->prd;
+	struct siw_hal_prd_stream *stream = &prd->stream;
 	int ret = 0;
 
 	if (!offset) {
@@ -3218,10 +3995,24 @@ static int prd_show_prd_get_data_raw_core(struct device *dev,
 		goto out;
 	}
 
+	mutex_lock(&stream->lock);
+
 	if (cmd != IT_DONT_USE_CMD) {
+		if (stream->active && (stream->cmd == cmd)) {
+			/* re-arm : release the held image before the next stop */
+			ret = siw_hal_write_value(dev,
+						reg->prd_ic_ait_start_reg,
+						IT_IMAGE_NONE);
+			if (ret < 0) {
+				goto out_unlock;
+			}
+		}
 		ret = prd_stop_firmware(prd, cmd, flag);
 		if (ret < 0) {
-			goto out;
+			goto out_unlock;
+		}
+		if (stream->active) {
+			stream->cmd = cmd;
 		}
 	}
 
@@ -3229,7 +4020,7 @@ static int prd_show_prd_get_data_raw_core(struct device *dev,
 				reg->serial_data_offset,
 				offset);
 	if (ret < 0) {
-		goto out;
+		goto out_unlock;
 	}
 
 	memset(buf, 0, size);
@@ -3238,9 +4029,20 @@ static int prd_show_prd_get_data_raw_core(struct device *dev,
 					(void *)buf,
 					size);
 	if (ret < 0) {
-		goto out;
+		goto out_unlock;
 	}
 
+	if (stream->active && (stream->cmd != IT_IMAGE_NONE)) {
+		stream->last = jiffies;
+		if (!delayed_work_pending(&stream->idle_work)) {
+			schedule_delayed_work(&stream->idle_work,
+					msecs_to_jiffies(PRD_STREAM_IDLE_MS));
+		}
+	}
+
+out_unlock:
+	mutex_unlock(&stream->lock);
+
 out:
 	return ret;
 }
@@ -3792,6 +4594,274 @@ out:
 }
 
 
+/*
+ * Noise profile
+ *
+ * Captures N frames of the given rawdata test and keeps only
+ * per-node sum/min/max, then reduces them to mean and
+ * peak-to-peak jitter. The reduced frames replace the rawdata
+ * buffers and go to the result log, sysfs gets the summary.
+ */
+struct siw_hal_prd_noise_acc {
+	s32 sum;
+	int16_t min;
+	int16_t max;
+};
+
+static void prd_noise_acc(struct siw_hal_prd_noise_acc *acc,
+			int16_t *raw, int row, int col, int col_add)
+{
+	int i, j;
+	int v;
+
+	for (i = 0; i < row; i++) {
+		for (j = 0; j < col; j++) {
+			v = raw[j];
+			acc->sum += v;
+			acc->min = (v < acc->min) ? v : acc->min;
+			acc->max = (v > acc->max) ? v : acc->max;
+			acc++;
+		}
+		raw += (col + col_add);
+	}
+}
+
+static void prd_noise_reduce(struct siw_hal_prd_noise_acc *acc,
+			int16_t *raw, int row, int col, int col_add,
+			int frames, int p2p)
+{
+	int i, j;
+
+	for (i = 0; i < row; i++) {
+		for (j = 0; j < col; j++) {
+			raw[j] = (p2p) ? (acc->max - acc->min) :
+					(int16_t)(acc->sum / frames);
+			acc++;
+		}
+		raw += (col + col_add);
+	}
+}
+
+static int prd_noise_capture(struct siw_hal_prd_data *prd,
+			int type, int frames, char *buf, int size)
+{
+	struct siw_hal_prd_param *param = &prd->param;
+	struct siw_hal_prd_noise_acc *acc = NULL;
+	struct siw_hal_prd_stat stat;
+	int16_t *buf_rawdata[MAX_TEST_CNT] = {
+		[0] = prd->m2_buf_even_rawdata,
+		[1] = prd->m2_buf_odd_rawdata,
+	};
+	char *name[MAX_TEST_CNT] = {
+		[0] = "EVEN",
+		[1] = "ODD",
+	};
+	char title[32];
+	int row = param->row;
+	int col = param->col;
+	int col_add = param->col_add;
+	int test_cnt = param->m2_cnt;
+	int nodes;
+	int log_size;
+	int i, k, n;
+	int ret = 0;
+
+	if (type == U0_M1_RAWDATA_TEST) {
+		buf_rawdata[0] = prd->m1_buf_even_rawdata;
+		buf_rawdata[1] = prd->m1_buf_odd_rawdata;
+		col = param->m1_col;
+		col_add = 0;
+		test_cnt = param->m1_cnt;
+	}
+	test_cnt = min(test_cnt, (int)MAX_TEST_CNT);
+	nodes = row * col;
+
+	acc = kcalloc(nodes * test_cnt, sizeof(*acc), GFP_KERNEL);
+	if (acc == NULL) {
+		return -ENOMEM;
+	}
+	for (i = 0; i < (nodes * test_cnt); i++) {
+		acc[i].min = S16_MAX;
+		acc[i].max = S16_MIN;
+	}
+
+	for (n = 0; n < frames; n++) {
+		ret = prd_write_test_mode(prd, type);
+		if (ret <= 0) {
+			ret = (ret < 0) ? ret : -ETIMEDOUT;
+			goto out;
+		}
+
+		ret = prd_read_rawdata(prd, type);
+		if (ret < 0) {
+			goto out;
+		}
+
+		for (k = 0; k < test_cnt; k++) {
+			prd_noise_acc(&acc[k * nodes], buf_rawdata[k],
+					row, col, col_add);
+		}
+	}
+
+	memset(prd->buf_write, 0, PRD_BUF_SIZE);
+	log_size = siw_prd_buf_snprintf(prd->buf_write, 0,
+				"\n\n[NOISE type %d, %d frames]\n",
+				type, frames);
+
+	for (k = 0; k < test_cnt; k++) {
+		prd_noise_reduce(&acc[k * nodes], buf_rawdata[k],
+				row, col, col_add, frames, 0);
+		snprintf(title, sizeof(title), "%s Mean", name[k]);
+		log_size = prd_print_s16(prd, prd->buf_write, log_size,
+					buf_rawdata[k], row, col, title, !!col_add);
+		prd_stat_calc(prd, &stat, buf_rawdata[k],
+				row, col, col_add, NULL, NULL);
+		size += siw_snprintf(buf, size,
+					"%s mean %d (min %d, max %d)\n",
+					name[k], stat.mean, stat.min, stat.max);
+
+		prd_noise_reduce(&acc[k * nodes], buf_rawdata[k],
+				row, col, col_add, frames, 1);
+		snprintf(title, sizeof(title), "%s P2P", name[k]);
+		log_size = prd_print_s16(prd, prd->buf_write, log_size,
+					buf_rawdata[k], row, col, title, !!col_add);
+		prd_stat_calc(prd, &stat, buf_rawdata[k],
+				row, col, col_add, NULL, NULL);
+		size += siw_snprintf(buf, size,
+					"%s p2p max %d, mean %d, stddev %d\n",
+					name[k], stat.max, stat.mean, stat.stddev);
+	}
+
+	prd_write_file(prd, prd->buf_write, TIME_INFO_WRITE);
+
+	ret = size;
+
+out:
+	kfree(acc);
+
+	return ret;
+}
+
+static ssize_t prd_show_noise(struct device *dev, char *buf)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	struct siw_hal_prd_data *prd = (struct siw_hal_prd_data *)ts->prd;
+	int type = prd->noise_type;
+	int frames = prd->noise_frames;
+	int size = 0;
+	int ret = 0;
+
+	if (!type) {
+		if (chip->lcd_mode == LCD_MODE_U3) {
+			type = U3_M2_RAWDATA_TEST;
+		} else if (chip->lcd_mode == LCD_MODE_U0) {
+			type = U0_M2_RAWDATA_TEST;
+		} else {
+			size += siw_snprintf(buf, size,
+						"Current LCD mode(%d) is not U3 or U0, halted\n",
+						chip->lcd_mode);
+			return (ssize_t)size;
+		}
+	}
+
+	if (!frames) {
+		frames = PRD_NOISE_FRAMES_DEF;
+	}
+
+	t_prd_info(prd, "======== NOISE(%d, %d frames) ========\n",
+		type, frames);
+
+	siw_touch_mon_pause(dev);
+
+	mutex_lock(&ts->lock);
+
+	ret = prd_write_test_control(prd, CMD_TEST_ENTER);
+	if (ret < 0) {
+		goto out;
+	}
+
+	siw_touch_irq_control(dev, INTERRUPT_DISABLE);
+
+	ret = prd_chip_driving(dev, LCD_MODE_STOP);
+	if (ret >= 0) {
+		ret = prd_noise_capture(prd, type, frames, buf, size);
+	}
+
+	siw_touch_irq_control(dev, INTERRUPT_ENABLE);
+
+	if (ret < 0) {
+		goto out;
+	}
+	size = ret;
+
+	ret = prd_write_test_control(prd, CMD_TEST_EXIT);
+
+out:
+	mutex_unlock(&ts->lock);
+
+	prd_chip_driving(dev, LCD_MODE_U3);
+	prd_chip_reset(dev);
+
+	siw_touch_mon_resume(dev);
+
+	if (ret < 0) {
+		t_prd_err(prd, "noise capture failed, %d\n", ret);
+	}
+
+	size += siw_snprintf(buf, size, "Noise result:\n");
+	size += siw_snprintf(buf, size, "%s\n",
+				(ret < 0) ? "Fail" : "Pass");
+
+	return (ssize_t)size;
+}
+
+static ssize_t prd_store_noise(struct device *dev,
+				const char *buf, size_t count)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	struct siw_hal_prd_data *prd = (struct siw_hal_prd_data *)ts->prd;
+	int frames = 0;
+	int type = 0;
+
+	if (sscanf(buf, "%d %d", &frames, &type) <= 0) {
+		siw_prd_sysfs_err_invalid_param(prd);
+		goto usage;
+	}
+
+	if ((frames < 0) || (frames > PRD_NOISE_FRAMES_MAX)) {
+		t_prd_err(prd, "invalid frames, %d\n", frames);
+		goto usage;
+	}
+
+	switch (type) {
+	case 0:		/* by LCD mode */
+	case U3_M2_RAWDATA_TEST:
+	case U0_M2_RAWDATA_TEST:
+	case U0_M1_RAWDATA_TEST:
+		break;
+	default:
+		t_prd_err(prd, "invalid type, %d\n", type);
+		goto usage;
+	}
+
+	prd->noise_frames = frames;
+	prd->noise_type = type;
+
+	t_prd_info(prd, "noise : %d frames, type %d\n", frames, type);
+
+	return (ssize_t)count;
+
+usage:
+	t_prd_info(prd, "usage: echo <frames(0:%d, max %d)> [type] > noise\n",
+		PRD_NOISE_FRAMES_DEF, PRD_NOISE_FRAMES_MAX);
+	t_prd_info(prd, "  type 0(by LCD mode), %d(U3_M2), %d(U0_M2), %d(U0_M1)\n",
+		U3_M2_RAWDATA_TEST, U0_M2_RAWDATA_TEST, U0_M1_RAWDATA_TEST);
+
+	return (ssize_t)count;
+}
+
 static ssize_t prd_show_prd_get_data(struct device *dev, int type)
 {
 	struct siw_touch_chip *chip = to_touch_chip(dev);
@@ -4100,6 +5170,9 @@ static ssize_t prd_store_file_test(struct device *dev,
 		goto out;
 	}
 
+	/* pending results go out before the file is touched */
+	prd_log_flush(prd);
+
 	ret = prd_vfs_file_chk(prd, fname, O_RDONLY, 0666, NULL);
 	if (ret < 0) {
 		/* */
@@ -4226,6 +5299,7 @@ static ssize_t prd_show_app_op_end(struct device *dev, char *buf, int prev_mode)
 	buf[0] = REPORT_END_RS_OK;
 	if (prev_mode != REPORT_OFF) {
 		prd->prd_app_mode = REPORT_OFF;
+		prd_stream_close(prd);
 		ret = prd_start_firmware(prd);
 		if (ret < 0) {
 			t_prd_err(prd, "prd_start_firmware failed, %d\n", ret);
@@ -4260,6 +5334,7 @@ static ssize_t prd_show_app_operator(struct device *dev, char *buf, int mode)
 
 	if (mode < REPORT_MAX) {
 		prd->prd_app_mode = mode;
+		prd_stream_open(prd);
 	}
 
 	switch (mode) {
@@ -4373,6 +5448,308 @@ static ssize_t prd_show_app_info(struct device *dev, char *buf)
 	return PRD_APP_INFO_SIZE;
 }
 
+static int prd_cdev_frame_size(struct siw_hal_prd_data *prd, int mode)
+{
+	struct siw_hal_prd_ctrl *ctrl = &prd->ctrl;
+
+	switch (mode) {
+	case REPORT_RAW:
+	case REPORT_BASE:
+	case REPORT_DELTA:
+		return (ctrl->m2_row_col_size<<PRD_RAWDATA_SZ_POW);
+	case REPORT_LABEL:
+		return ctrl->m2_row_col_size;
+	case REPORT_DEBUG_BUF:
+		return ctrl->debug_buf_size;
+	}
+
+	return 0;
+}
+
+/*
+ * Same frames as prd_show_app_operator, read straight into the back buffer
+ */
+static int prd_cdev_grab(struct siw_hal_prd_data *prd)
+{
+	struct device *dev = prd->dev;
+	struct siw_hal_prd_cdev *cdev = &prd->cdev;
+	struct siw_prd_mmap_ctrl *ctrl = cdev->ctrl;
+	int flag = PRD_SHOW_FLAG_DISABLE_PRT_RAW;
+	int mode = cdev->mode;
+	u32 back = !cdev->front;
+	u8 *pbuf = cdev->frame[back];
+	int size = prd_cdev_frame_size(prd, mode);
+	int ret = 0;
+
+	switch (mode) {
+	case REPORT_RAW:
+		ret = prd_show_prd_get_data_do_raw_ait(dev, pbuf, size, flag);
+		break;
+	case REPORT_BASE:
+		ret = prd_show_prd_get_data_do_ait_basedata(dev, pbuf, size, 0, flag);
+		break;
+	case REPORT_DELTA:
+		ret = prd_show_prd_get_data_do_deltadata(dev, pbuf, size, flag);
+		break;
+	case REPORT_LABEL:
+		ret = prd_show_prd_get_data_do_labeldata(dev, pbuf, size, flag);
+		break;
+	case REPORT_DEBUG_BUF:
+		ret = prd_show_prd_get_data_do_debug_buf(dev, pbuf, size, flag);
+		break;
+	default:
+		return -EINVAL;
+	}
+	if (ret < 0) {
+		return ret;
+	}
+
+	cdev->front = back;
+	cdev->seq++;
+
+	WRITE_ONCE(ctrl->len, size);
+	/* frame before front */
+	smp_wmb();
+	WRITE_ONCE(ctrl->front, cdev->front);
+	WRITE_ONCE(ctrl->seq, cdev->seq);
+
+	return size;
+}
+
+static int prd_cdev_set_mode(struct siw_hal_prd_data *prd, u32 mode)
+{
+	struct siw_hal_prd_cdev *cdev = &prd->cdev;
+	struct siw_prd_mmap_ctrl *ctrl = cdev->ctrl;
+	int ret = 0;
+
+	if (mode >= REPORT_MAX) {
+		return -EINVAL;
+	}
+
+	if ((mode == REPORT_OFF) && (cdev->mode != REPORT_OFF)) {
+		ret = prd_start_firmware(prd);
+		if (ret < 0) {
+			t_prd_err(prd, "prd_start_firmware failed, %d\n", ret);
+		}
+	}
+
+	t_prd_info(prd, "cdev mode : %s(%d)\n", prd_app_mode_str[mode], mode);
+
+	cdev->mode = mode;
+	WRITE_ONCE(ctrl->mode, mode);
+	prd->prd_app_mode = mode;
+
+	return ret;
+}
+
+static int prd_cdev_open(struct inode *inode, struct file *filp)
+{
+	struct miscdevice *misc = filp->private_data;
+	struct siw_hal_prd_cdev *cdev = container_of(misc, struct siw_hal_prd_cdev, misc);
+	struct siw_hal_prd_data *prd = cdev->prd;
+	struct siw_hal_prd_param *param = &prd->param;
+	struct siw_prd_mmap_ctrl *ctrl;
+	int i;
+	int ret = 0;
+
+	mutex_lock(&cdev->lock);
+
+	if (cdev->users) {
+		ret = -EBUSY;
+		goto out;
+	}
+
+	cdev->buf = vmalloc_user(cdev->buf_size);
+	if (!cdev->buf) {
+		t_prd_err(prd, "cdev: failed to allocate %d bytes\n", cdev->buf_size);
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	ctrl = cdev->buf;
+	ctrl->magic = SIW_PRD_MMAP_MAGIC;
+	ctrl->version = SIW_PRD_MMAP_VER;
+	ctrl->frame_size = cdev->frame_size;
+	for (i = 0; i < SIW_PRD_MMAP_BUF_NUM; i++) {
+		ctrl->frame_offset[i] = PAGE_SIZE + (i * cdev->frame_size);
+		cdev->frame[i] = (u8 *)cdev->buf + ctrl->frame_offset[i];
+	}
+	cdev->mode = REPORT_OFF;
+	cdev->front = 0;
+	cdev->seq = 0;
+	ctrl->mode = cdev->mode;
+	ctrl->front = cdev->front;
+	ctrl->seq = cdev->seq;
+	ctrl->row = param->row;
+	ctrl->col = param->col;
+	ctrl->col_add = param->col_add;
+	ctrl->ch = param->ch;
+	ctrl->m1_col = param->m1_col;
+	ctrl->cmd_type = param->cmd_type;
+	cdev->ctrl = ctrl;
+
+	siw_touch_mon_pause(prd->dev);
+
+	prd_stream_open(prd);
+
+	cdev->users++;
+	filp->private_data = cdev;
+
+out:
+	mutex_unlock(&cdev->lock);
+
+	return ret;
+}
+
+static int prd_cdev_release(struct inode *inode, struct file *filp)
+{
+	struct siw_hal_prd_cdev *cdev = filp->private_data;
+	struct siw_hal_prd_data *prd = cdev->prd;
+
+	mutex_lock(&cdev->lock);
+
+	prd_stream_close(prd);
+
+	prd_cdev_set_mode(prd, REPORT_OFF);
+
+	siw_touch_mon_resume(prd->dev);
+
+	vfree(cdev->buf);
+	cdev->buf = NULL;
+	cdev->ctrl = NULL;
+	cdev->users--;
+
+	mutex_unlock(&cdev->lock);
+
+	return 0;
+}
+
+static ssize_t prd_cdev_read(struct file *filp, char __user *buf,
+			size_t count, loff_t *ppos)
+{
+	struct siw_hal_prd_cdev *cdev = filp->private_data;
+	struct siw_hal_prd_data *prd = cdev->prd;
+	int ret;
+
+	mutex_lock(&cdev->lock);
+
+	if (count < prd_cdev_frame_size(prd, cdev->mode)) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	ret = prd_cdev_grab(prd);
+	if (ret < 0) {
+		goto out;
+	}
+
+	if (copy_to_user(buf, cdev->frame[cdev->front], ret)) {
+		ret = -EFAULT;
+	}
+
+out:
+	mutex_unlock(&cdev->lock);
+
+	return ret;
+}
+
+static long prd_cdev_ioctl(struct file *filp,
+			unsigned int cmd, unsigned long arg)
+{
+	struct siw_hal_prd_cdev *cdev = filp->private_data;
+	struct siw_hal_prd_data *prd = cdev->prd;
+	u32 mode;
+	long ret;
+
+	mutex_lock(&cdev->lock);
+
+	switch (cmd) {
+	case SIW_PRD_IOC_SET_MODE:
+		if (get_user(mode, (u32 __user *)arg)) {
+			ret = -EFAULT;
+			break;
+		}
+		ret = prd_cdev_set_mode(prd, mode);
+		break;
+	case SIW_PRD_IOC_GRAB:
+		ret = prd_cdev_grab(prd);
+		break;
+	default:
+		ret = -ENOTTY;
+		break;
+	}
+
+	mutex_unlock(&cdev->lock);
+
+	return ret;
+}
+
+static int prd_cdev_mmap(struct file *filp, struct vm_area_struct *vma)
+{
+	struct siw_hal_prd_cdev *cdev = filp->private_data;
+
+	return remap_vmalloc_range(vma, cdev->buf, vma->vm_pgoff);
+}
+
+static const struct file_operations prd_cdev_fops = {
+	.owner			= THIS_MODULE,
+	.open			= prd_cdev_open,
+	.release		= prd_cdev_release,
+	.read			= prd_cdev_read,
+	.unlocked_ioctl	= prd_cdev_ioctl,
+	.mmap			= prd_cdev_mmap,
+	.llseek			= no_llseek,
+};
+
+static int prd_cdev_init(struct siw_hal_prd_data *prd)
+{
+	struct siw_hal_prd_cdev *cdev = &prd->cdev;
+	struct miscdevice *misc = &cdev->misc;
+	int size = 0;
+	int mode;
+	int ret;
+
+	for (mode = REPORT_RAW; mode < REPORT_MAX; mode++) {
+		size = max(size, prd_cdev_frame_size(prd, mode));
+	}
+	cdev->frame_size = PAGE_ALIGN(size);
+	cdev->buf_size = PAGE_SIZE + (cdev->frame_size * SIW_PRD_MMAP_BUF_NUM);
+
+	mutex_init(&cdev->lock);
+	cdev->prd = prd;
+
+	snprintf(cdev->name, sizeof(cdev->name), "%s", prd->name);
+
+	misc->minor = MISC_DYNAMIC_MINOR;
+	misc->name = cdev->name;
+	misc->fops = &prd_cdev_fops;
+
+	ret = misc_register(misc);
+	if (ret < 0) {
+		t_prd_err(prd, "cdev: misc_register failed, %d\n", ret);
+		mutex_destroy(&cdev->lock);
+		cdev->prd = NULL;
+		return ret;
+	}
+
+	t_prd_dbg_base(prd, "cdev: /dev/%s, frame %d\n", cdev->name, size);
+
+	return 0;
+}
+
+static void prd_cdev_free(struct siw_hal_prd_data *prd)
+{
+	struct siw_hal_prd_cdev *cdev = &prd->cdev;
+
+	if (cdev->prd == NULL) {
+		return;
+	}
+
+	misc_deregister(&cdev->misc);
+	mutex_destroy(&cdev->lock);
+	cdev->prd = NULL;
+}
+
 
 #if defined(__SIW_ATTR_PERMISSION_ALL)
 #define __TOUCH_PRD_PERM	(S_IRUGO | S_IWUGO)
@@ -4404,6 +5781,7 @@ static SIW_TOUCH_HAL_PRD_ATTR(prd_app_delta, prd_show_app_delta, NULL);
 static SIW_TOUCH_HAL_PRD_ATTR(prd_app_debug_buf, prd_show_app_debug_buf, NULL);
 static SIW_TOUCH_HAL_PRD_ATTR(prd_app_end, prd_show_app_end, NULL);
 static SIW_TOUCH_HAL_PRD_ATTR(prd_app_info, prd_show_app_info, NULL);
+static SIW_TOUCH_HAL_PRD_ATTR(noise, prd_show_noise, prd_store_noise);
 
 static struct attribute *siw_hal_prd_attribute_list_all[] = {
 	/*
@@ -4427,6 +5805,7 @@ static struct attribute *siw_hal_prd_attribute_list_all[] = {
 	&_SIW_TOUCH_HAL_PRD_T(prd_app_debug_buf).attr,
 	&_SIW_TOUCH_HAL_PRD_T(prd_app_end).attr,
 	&_SIW_TOUCH_HAL_PRD_T(prd_app_info).attr,
+	&_SIW_TOUCH_HAL_PRD_T(noise).attr,
 	NULL,
 };
 
@@ -4512,6 +5891,10 @@ static void siw_hal_prd_free_buffer(struct device *dev)
 		prd->buf_label_tmp = NULL;
 		prd->buf_label = NULL;
 	}
+
+	kfree(prd->fail_map);
+	prd->fail_map = NULL;
+	prd->fail_map_bits = 0;
 }
 
 static int siw_hal_prd_alloc_buffer(struct device *dev)
@@ -4579,6 +5962,16 @@ static int siw_hal_prd_alloc_buffer(struct device *dev)
 	prd->buf_label = (u8 *)buf;
 //	buf += ctrl->m2_row_col_size;
 
+	prd->fail_map_bits = max(ctrl->m2_row_col_size, ctrl->m1_row_col_size);
+	prd->fail_map = kcalloc(BITS_TO_LONGS(prd->fail_map_bits),
+				sizeof(unsigned long), GFP_KERNEL);
+	if (prd->fail_map == NULL) {
+		/* compare still gives the verdict, without fail lines */
+		t_prd_warn(prd, "failed to allocate fail map(%d)\n",
+			prd->fail_map_bits);
+		prd->fail_map_bits = 0;
+	}
+
 	return 0;
 }
 
@@ -4894,6 +6287,11 @@ static int siw_hal_prd_init_param(struct device *dev)
 
 static void siw_hal_prd_free_param(struct device *dev)
 {
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+
+	prd_spec_free((struct siw_hal_prd_data *)ts->prd);
+
 	siw_hal_prd_free_buffer(dev);
 }
 
@@ -4917,6 +6315,8 @@ static struct siw_hal_prd_data *siw_hal_prd_alloc(struct device *dev)
 
 	prd->dev = ts->dev;
 
+	prd_stream_init(prd);
+
 	ts->prd = prd;
 
 	return prd;
@@ -4975,6 +6375,11 @@ static int siw_hal_prd_create_sysfs(struct device *dev)
 	t_dev_dbg_base(dev, "%s prd sysfs registered\n",
 			touch_chip_name(ts));
 
+	prd_log_init(prd);
+
+	/* binary frame device is optional */
+	prd_cdev_init(prd);
+
 out_skip:
 	return 0;
 
@@ -5003,8 +6408,14 @@ static void siw_hal_prd_remove_sysfs(struct device *dev)
 		return;
 	}
 
+	prd_cdev_free((struct siw_hal_prd_data *)ts->prd);
+
 	siw_hal_prd_remove_group(dev);
 
+	prd_stream_close((struct siw_hal_prd_data *)ts->prd);
+
+	prd_log_free((struct siw_hal_prd_data *)ts->prd);
+
 	siw_hal_prd_free_param(dev);
 
 	siw_hal_prd_free(dev);
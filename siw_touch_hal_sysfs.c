@@ -493,6 +493,46 @@ static ssize_t _store_lcd_mode(struct device *dev,
 	return count;
 }
 
+static ssize_t _show_irq_stat(struct device *dev, char *buf)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+	struct siw_hal_irq_stat *stat = &chip->irq_stat;
+	int size = 0;
+
+	size += siw_snprintf(buf, size, "zero-copy  : %s\n",
+				(touch_flags(ts) & IRQ_USE_ZERO_COPY) ? "on" : "off");
+	size += siw_snprintf(buf, size, "irq count  : %d\n",
+				stat->cnt);
+	size += siw_snprintf(buf, size, "top-up     : %d\n",
+				stat->topup);
+	size += siw_snprintf(buf, size, "read last  : %d bytes\n",
+				stat->rd_last);
+	size += siw_snprintf(buf, size, "read total : %lld bytes\n",
+				(long long)stat->rd_total);
+	size += siw_snprintf(buf, size, "copy last  : %d bytes\n",
+				stat->copy_last);
+	size += siw_snprintf(buf, size, "copy total : %lld bytes\n",
+				(long long)stat->copy_total);
+
+	return size;
+}
+
+static ssize_t _store_irq_stat(struct device *dev,
+				const char *buf, size_t count)
+{
+	struct siw_touch_chip *chip = to_touch_chip(dev);
+	struct siw_ts *ts = chip->ts;
+
+	mutex_lock(&ts->lock);
+	memset(&chip->irq_stat, 0, sizeof(chip->irq_stat));
+	mutex_unlock(&ts->lock);
+
+	t_dev_info(dev, "irq stat cleared\n");
+
+	return count;
+}
+
 #if defined(__SIW_USE_BUS_TEST)
 u32 t_dbg_bus_cnt = 10000;
 module_param_named(dbg_bus_cnt, t_dbg_bus_cnt, uint, S_IRUGO|S_IWUSR|S_IWGRP);
@@ -640,6 +680,7 @@ static SIW_TOUCH_HAL_ATTR(reset_sw, _show_reset_sw, NULL);
 static SIW_TOUCH_HAL_ATTR(reset_hw, _show_reset_hw, NULL);
 #endif
 static SIW_TOUCH_HAL_ATTR(lcd_mode, _show_lcd_mode, _store_lcd_mode);
+static SIW_TOUCH_HAL_ATTR(irq_stat, _show_irq_stat, _store_irq_stat);
 #if defined(__SIW_USE_BUS_TEST)
 static SIW_TOUCH_HAL_ATTR(debug_bus, _show_debug_bus, NULL);
 #endif
@@ -654,6 +695,7 @@ static struct attribute *siw_hal_attribute_list[] = {
 	&_SIW_TOUCH_HAL_ATTR_T(reset_hw).attr,
 #endif
 	&_SIW_TOUCH_HAL_ATTR_T(lcd_mode).attr,
+	&_SIW_TOUCH_HAL_ATTR_T(irq_stat).attr,
 #if defined(__SIW_USE_BUS_TEST)
 	&_SIW_TOUCH_HAL_ATTR_T(debug_bus).attr,
 #endif
@@ -0,0 +1,239 @@
+/*
+ * siw_touch_lat.c - SiW touch latency histogram
+ *
+ * Copyright (C) 2016 Silicon Works - http://www.siliconworks.co.kr
+ * Author: Hyunho Kim <kimhh@siliconworks.co.kr>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#include "siw_touch_cfg.h"
+
+#if defined(__SIW_SUPPORT_LAT_HIST)	//See siw_touch_cfg.h
+
+#include <linux/kernel.h>
+#include <linux/types.h>
+#include <linux/module.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+#include <linux/ktime.h>
+#include <linux/log2.h>
+#include <linux/math64.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <asm/uaccess.h>
+
+#include "siw_touch.h"
+
+/*
+ * Per-stage latency histograms between the irq edge and input_sync
+ *
+ * Each bin covers [2^n, 2^(n+1)) ns, so p50/p99 are reported as
+ * the upper bound of the bin they fall in (clipped by max).
+ *
+ * /sys/kernel/debug/{drv name}/latency
+ * read  : count, p50, p99 and max of each stage in us
+ * write : reset
+ */
+
+static const char *siw_lat_stage_str[SIW_LAT_STAMP_MAX] = {
+	[SIW_LAT_IRQ]		= "total",
+	[SIW_LAT_RD_START]	= "wakeup",
+	[SIW_LAT_RD_END]	= "bus_read",
+	[SIW_LAT_DECODE]	= "decode",
+	[SIW_LAT_REPORT]	= "report",
+};
+
+static void siw_touch_lat_hist_add(struct siw_touch_lat_hist *hist, s64 ns)
+{
+	int bin = 0;
+
+	if (ns < 0)
+		ns = 0;
+
+	if (ns > 1)
+		bin = min_t(int, ilog2((u64)ns), SIW_LAT_HIST_BINS - 1);
+
+	hist->bin[bin]++;
+	hist->cnt++;
+	if ((u64)ns > hist->max)
+		hist->max = ns;
+}
+
+static u64 siw_touch_lat_hist_pct(struct siw_touch_lat_hist *hist, int pct)
+{
+	u64 target = div_u64((u64)hist->cnt * pct + 99, 100);
+	u64 sum = 0;
+	int i;
+
+	if (!hist->cnt)
+		return 0;
+
+	for (i = 0; i < SIW_LAT_HIST_BINS; i++) {
+		sum += hist->bin[i];
+		if (sum >= target)
+			return min_t(u64, 1ULL<<(i + 1), hist->max);
+	}
+
+	return hist->max;
+}
+
+/*
+ * Stages without both stamps of this irq are skipped
+ */
+void __siw_touch_lat_commit(struct siw_ts *ts, ktime_t *stamp, u32 valid)
+{
+	struct siw_touch_lat *lat = &ts->lat;
+	s64 ns;
+	int i;
+
+	if (!(valid & (1<<SIW_LAT_IRQ)))
+		return;
+
+	spin_lock(&lat->lock);
+
+	if (valid & (1<<SIW_LAT_REPORT)) {
+		ns = ktime_to_ns(ktime_sub(stamp[SIW_LAT_REPORT],
+						stamp[SIW_LAT_IRQ]));
+		siw_touch_lat_hist_add(&lat->hist[SIW_LAT_IRQ], ns);
+	}
+
+	for (i = 1; i < SIW_LAT_STAMP_MAX; i++) {
+		if (!(valid & (1<<i)) || !(valid & (1<<(i - 1))))
+			continue;
+
+		ns = ktime_to_ns(ktime_sub(stamp[i], stamp[i - 1]));
+		siw_touch_lat_hist_add(&lat->hist[i], ns);
+	}
+
+	spin_unlock(&lat->lock);
+}
+
+/*
+ * Called at the end of the irq thread,
+ * a frame queued for the reporter has taken the stamps already
+ * (see siw_touch_frame_push)
+ */
+void siw_touch_lat_commit(struct siw_ts *ts)
+{
+	struct siw_touch_lat *lat = &ts->lat;
+	u32 valid = lat->valid;
+
+	lat->valid = 0;
+
+	__siw_touch_lat_commit(ts, lat->stamp, valid);
+}
+
+static int siw_touch_lat_show(struct seq_file *m, void *v)
+{
+	struct siw_ts *ts = m->private;
+	struct siw_touch_lat *lat = &ts->lat;
+	struct siw_touch_lat_hist *hist;
+	int size = sizeof(lat->hist);
+	int i;
+
+	hist = kmalloc(size, GFP_KERNEL);
+	if (!hist)
+		return -ENOMEM;
+
+	spin_lock(&lat->lock);
+	memcpy(hist, lat->hist, size);
+	spin_unlock(&lat->lock);
+
+	seq_printf(m, "%-10s %10s %10s %10s %10s\n",
+			"stage", "count", "p50(us)", "p99(us)", "max(us)");
+
+	for (i = 0; i < SIW_LAT_STAMP_MAX; i++) {
+		seq_printf(m, "%-10s %10u %10llu %10llu %10llu\n",
+			siw_lat_stage_str[i],
+			hist[i].cnt,
+			div_u64(siw_touch_lat_hist_pct(&hist[i], 50), 1000),
+			div_u64(siw_touch_lat_hist_pct(&hist[i], 99), 1000),
+			div_u64(hist[i].max, 1000));
+	}
+
+	kfree(hist);
+
+	return 0;
+}
+
+static int siw_touch_lat_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, siw_touch_lat_show, inode->i_private);
+}
+
+static ssize_t siw_touch_lat_write(struct file *file,
+				const char __user *buf,
+				size_t count, loff_t *ppos)
+{
+	struct seq_file *m = file->private_data;
+	struct siw_ts *ts = m->private;
+	struct siw_touch_lat *lat = &ts->lat;
+
+	spin_lock(&lat->lock);
+	memset(lat->hist, 0, sizeof(lat->hist));
+	spin_unlock(&lat->lock);
+
+	t_dev_info(ts->dev, "latency histogram cleared\n");
+
+	return count;
+}
+
+static const struct file_operations siw_touch_lat_fops = {
+	.owner		= THIS_MODULE,
+	.open		= siw_touch_lat_open,
+	.read		= seq_read,
+	.write		= siw_touch_lat_write,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+int siw_touch_lat_init(struct device *dev)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+	struct siw_touch_lat *lat = &ts->lat;
+	struct dentry *root = NULL;
+	struct dentry *file = NULL;
+	char *name = NULL;
+
+	name = touch_drv_name(ts);
+	if (!name) {
+		name = SIW_TOUCH_NAME;
+	}
+
+	root = debugfs_create_dir(name, NULL);
+	if (IS_ERR_OR_NULL(root)) {
+		t_dev_err(dev, "failed to create debugfs dir, %s\n", name);
+		return -ENOMEM;
+	}
+
+	file = debugfs_create_file("latency", 0644, root, ts,
+					&siw_touch_lat_fops);
+	if (IS_ERR_OR_NULL(file)) {
+		t_dev_err(dev, "failed to create debugfs latency\n");
+		debugfs_remove_recursive(root);
+		return -ENOMEM;
+	}
+
+	lat->root = root;
+
+	t_dev_dbg_base(dev, "latency histogram: %s/latency\n", name);
+
+	return 0;
+}
+
+void siw_touch_lat_free(struct device *dev)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+	struct siw_touch_lat *lat = &ts->lat;
+
+	if (lat->root) {
+		debugfs_remove_recursive((struct dentry *)lat->root);
+		lat->root = NULL;
+	}
+}
+
+#endif	/* __SIW_SUPPORT_LAT_HIST */
+
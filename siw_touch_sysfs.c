@@ -32,6 +32,7 @@
 
 #include "siw_touch.h"
 #include "siw_touch_hal.h"
+#include "siw_touch_event.h"
 #include "siw_touch_irq.h"
 #include "siw_touch_sys.h"
 
@@ -230,6 +231,52 @@ static ssize_t _show_upgrade(struct device *dev, char *buf)
 	return 0;
 }
 
+static const char *__fwup_phase_str[FWUP_PHASE_MAX] = {
+	[FWUP_PHASE_IDLE]		= "idle",
+	[FWUP_PHASE_LOAD]		= "load",
+	[FWUP_PHASE_CHECK]		= "check",
+	[FWUP_PHASE_CUTOVER]	= "cutover",
+	[FWUP_PHASE_CODE]		= "code",
+	[FWUP_PHASE_FLASH]		= "flash",
+	[FWUP_PHASE_CONF]		= "conf",
+	[FWUP_PHASE_DONE]		= "done",
+};
+
+static ssize_t _show_upgrade_stat(struct device *dev, char *buf)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+	struct siw_touch_fwup_stat fwup;
+	int percent = 0;
+	int i;
+	int size = 0;
+
+	memcpy(&fwup, &ts->fwup, sizeof(fwup));
+
+	if (fwup.phase == FWUP_PHASE_DONE) {
+		percent = (fwup.result < 0) ? 0 : 100;
+	} else if (fwup.dn_total) {
+		percent = (int)div_u64((u64)fwup.dn_done * 100, fwup.dn_total);
+	}
+
+	size += siw_snprintf(buf, size,
+				"phase    : %s\n",
+				__fwup_phase_str[fwup.phase]);
+	size += siw_snprintf(buf, size,
+				"progress : %d%% (%d / %d bytes)\n",
+				percent, fwup.dn_done, fwup.dn_total);
+	size += siw_snprintf(buf, size,
+				"result   : %d\n",
+				fwup.result);
+
+	for (i = FWUP_PHASE_LOAD; i < FWUP_PHASE_DONE; i++) {
+		size += siw_snprintf(buf, size,
+					"%-8s : %d ms\n",
+					__fwup_phase_str[i], fwup.phase_ms[i]);
+	}
+
+	return (ssize_t)size;
+}
+
 static int __show_do_lpwg_data(struct device *dev, char *buf)
 {
 	struct siw_ts *ts = to_touch_core(dev);
@@ -995,6 +1042,40 @@ static ssize_t _store_irq_flag(struct device *dev,
 	return count;
 }
 
+static ssize_t _show_report_stat(struct device *dev, char *buf)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+	struct siw_touch_report_stat stat;
+	int size = 0;
+
+	/* owned by the reporter, a snapshot is enough here */
+	memcpy(&stat, &ts->rpt_stat, sizeof(stat));
+
+	size += siw_snprintf(buf, size,
+				"frames     : %d reported, %d dropped\n",
+				stat.frames, stat.dropped);
+	size += siw_snprintf(buf, size,
+				"axes       : %d emitted, %d suppressed\n",
+				stat.emitted, stat.suppressed);
+	size += siw_snprintf(buf, size,
+				"abs events : %d\n\n",
+				ts->abs_evt_cnt);
+
+	return (ssize_t)size;
+}
+
+static ssize_t _store_report_stat(struct device *dev,
+				const char *buf, size_t count)
+{
+	struct siw_ts *ts = to_touch_core(dev);
+
+	/* cleared by the reporter itself */
+	WRITE_ONCE(ts->rpt_stat_clr, 1);
+	siw_touch_report_flush(ts);
+
+	return count;
+}
+
 static ssize_t _store_init_late(struct device *dev,
 				const char *buf, size_t count)
 {
@@ -1098,6 +1179,8 @@ static SIW_TOUCH_ATTR(driver_data,
 static SIW_TOUCH_ATTR(fw_upgrade,
 						_show_upgrade,
 						_store_upgrade);
+static SIW_TOUCH_ATTR(fw_upgrade_stat,
+						_show_upgrade_stat, NULL);
 static SIW_TOUCH_ATTR(lpwg_data,
 						_show_lpwg_data,
 						_store_lpwg_data);
@@ -1167,6 +1250,9 @@ static SIW_TOUCH_ATTR(dbg_flag,
 static SIW_TOUCH_ATTR(irq_flag,
 						_show_irq_flag,
 						_store_irq_flag);
+static SIW_TOUCH_ATTR(report_stat,
+						_show_report_stat,
+						_store_report_stat);
 static SIW_TOUCH_ATTR(init_late, NULL,
 						_store_init_late);
 static SIW_TOUCH_ATTR(dbg_notify, NULL,
@@ -1179,6 +1265,7 @@ static struct attribute *siw_touch_attribute_list[] = {
 	&_SIW_TOUCH_ATTR_T(platform_data).attr,
 	&_SIW_TOUCH_ATTR_T(driver_data).attr,
 	&_SIW_TOUCH_ATTR_T(fw_upgrade).attr,
+	&_SIW_TOUCH_ATTR_T(fw_upgrade_stat).attr,
 	&_SIW_TOUCH_ATTR_T(lpwg_data).attr,
 	&_SIW_TOUCH_ATTR_T(lpwg_notify).attr,
 #if defined(__SYS_USE_LOCKSCREEN)
@@ -1208,6 +1295,7 @@ static struct attribute *siw_touch_attribute_list[] = {
 	&_SIW_TOUCH_ATTR_T(dbg_mask).attr,
 	&_SIW_TOUCH_ATTR_T(dbg_flag).attr,
 	&_SIW_TOUCH_ATTR_T(irq_flag).attr,
+	&_SIW_TOUCH_ATTR_T(report_stat).attr,
 	&_SIW_TOUCH_ATTR_T(init_late).attr,
 	&_SIW_TOUCH_ATTR_T(dbg_notify).attr,
 	&_SIW_TOUCH_ATTR_T(dbg_test).attr,
@@ -1270,6 +1358,26 @@ void __weak siw_touch_misc_free(struct device *dev)
 
 }
 
+int __weak siw_touch_lat_init(struct device *dev)
+{
+	return 0;
+}
+
+void __weak siw_touch_lat_free(struct device *dev)
+{
+
+}
+
+int __weak siw_touch_emul_init(struct device *dev)
+{
+	return 0;
+}
+
+void __weak siw_touch_emul_free(struct device *dev)
+{
+
+}
+
 int siw_touch_init_sysfs(struct siw_ts *ts)
 {
 	struct device *dev = ts->dev;
@@ -1305,6 +1413,10 @@ int siw_touch_init_sysfs(struct siw_ts *ts)
 
 	siw_touch_misc_init(dev);
 
+	siw_touch_lat_init(dev);
+
+	siw_touch_emul_init(dev);
+
 	return 0;
 
 out_sysfs:
@@ -1327,6 +1439,10 @@ void siw_touch_free_sysfs(struct siw_ts *ts)
 		return;
 	}
 
+	siw_touch_emul_free(dev);
+
+	siw_touch_lat_free(dev);
+
 	siw_touch_misc_free(dev);
 
 	siw_ops_sysfs(ts, DRIVER_FREE);
@@ -69,6 +69,7 @@
 									CHIP_QUIRK_NOT_SUPPORT_ASC |	\
 									CHIP_QUIRK_NOT_SUPPORT_WATCH |	\
 									CHIP_QUIRK_NOT_SUPPORT_IME |	\
+									CHIP_QUIRK_NOT_SUPPORT_FW_BURST |	\
 									__CHIP_QUIRK_ADD |	\
 									0)
 
@@ -76,6 +76,7 @@
 #define CHIP_QUIRKS					(0 |	\
 									CHIP_QUIRK_NOT_SUPPORT_ASC |	\
 									CHIP_QUIRK_NOT_SUPPORT_IME |	\
+									CHIP_QUIRK_NOT_SUPPORT_FW_BURST |	\
 									__CHIP_QUIRK_ADD |	\
 									0)
 
@@ -112,6 +112,7 @@
 									CHIP_QUIRK_NOT_SUPPORT_ASC |	\
 									__CHIP_QUIRKS_WATCH |	\
 									CHIP_QUIRK_NOT_SUPPORT_IME |	\
+									CHIP_QUIRK_NOT_SUPPORT_FW_BURST |	\
 									__CHIP_QUIRK_ADD |	\
 									0)
 